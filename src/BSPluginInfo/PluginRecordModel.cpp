@@ -17,10 +17,17 @@ PluginRecordModel::PluginRecordModel(MOBase::IOrganizer* organizer,
                                      const QString& pluginName)
     : m_PluginName{pluginName}, m_Organizer{organizer}, m_PluginList{pluginList},
       m_FileEntry{pluginList->findEntryByName(pluginName.toStdString())}
+{}
+
+PluginRecordModel::Item* PluginRecordModel::itemAt(const QModelIndex& index) const
 {
-  if (m_FileEntry) {
-    m_DataRoot = m_FileEntry->dataRoot();
+  if (!m_FileEntry) {
+    return nullptr;
   }
+
+  using ItemIndex = TESData::FileEntry::ItemIndex;
+  return index.isValid() ? m_FileEntry->item(static_cast<ItemIndex>(index.internalId()))
+                         : m_FileEntry->dataRoot();
 }
 
 TESData::RecordPath PluginRecordModel::getPath(const QModelIndex& index) const
@@ -28,14 +35,16 @@ TESData::RecordPath PluginRecordModel::getPath(const QModelIndex& index) const
   TESData::RecordPath path;
 
   std::vector<const Item*> parents;
-  const auto last = static_cast<const Item*>(index.internalPointer());
-  for (auto item = last; item->parent; item = item->parent) {
+  const auto last = itemAt(index);
+  for (const Item* item = last; item->parent != TESData::FileEntry::NoItem;
+       item             = m_FileEntry->item(item->parent)) {
     parents.push_back(item);
   }
 
+  const auto pluginId = TESData::FileNames::intern(m_PluginName.toStdString());
   for (const auto& item : std::ranges::reverse_view(parents)) {
     if (item->group.has_value()) {
-      path.push(item->group.value(), m_FileEntry->files(), m_PluginName.toStdString());
+      path.push(item->group.value(), m_FileEntry->files(), pluginId);
     }
   }
 
@@ -43,7 +52,8 @@ TESData::RecordPath PluginRecordModel::getPath(const QModelIndex& index) const
     if (last->group.has_value()) {
       path.pop();
     }
-    path.setIdentifier(last->record->identifier(), {&last->record->file(), 1});
+    const auto file = last->record->file();
+    path.setIdentifier(last->record->identifier(), {&file, 1});
   }
 
   return path;
@@ -55,15 +65,12 @@ QModelIndex PluginRecordModel::index(int row, int column,
   if (row < 0 || column < 0)
     return QModelIndex();
 
-  const auto parentItem = parent.isValid()
-                              ? static_cast<const Item*>(parent.internalPointer())
-                              : m_DataRoot;
-
-  if (!parentItem || row >= parentItem->children.size())
+  const auto parentItem = itemAt(parent);
+  if (!parentItem || row >= parentItem->childCount)
     return QModelIndex();
 
-  const auto item = parentItem->children.nth(row)->second.get();
-  return createIndex(row, column, item);
+  const auto children = m_FileEntry->children(*parentItem);
+  return createIndex(row, column, static_cast<quintptr>(children[row]));
 }
 
 QModelIndex PluginRecordModel::parent(const QModelIndex& index) const
@@ -71,36 +78,34 @@ QModelIndex PluginRecordModel::parent(const QModelIndex& index) const
   if (!index.isValid())
     return QModelIndex();
 
-  const auto item = static_cast<const Item*>(index.internalPointer());
-  if (!item->parent || !item->parent->parent) {
+  const auto item = itemAt(index);
+  if (item->parent == TESData::FileEntry::NoItem) {
     return QModelIndex();
   }
 
-  const auto& siblings = item->parent->parent->children;
-  const int row        = static_cast<int>(
-      siblings.index_of(std::ranges::find(siblings, item->parent, [&](auto&& pair) {
-        return pair.second.get();
-      })));
+  const auto parentItem = m_FileEntry->item(item->parent);
+  if (parentItem->parent == TESData::FileEntry::NoItem) {
+    return QModelIndex();
+  }
 
-  return createIndex(row, 0, item->parent);
+  return createIndex(static_cast<int>(parentItem->row), 0,
+                     static_cast<quintptr>(parentItem->index));
 }
 
 bool PluginRecordModel::hasChildren(const QModelIndex& parent) const
 {
+  const auto parentItem = itemAt(parent);
   if (!parent.isValid()) {
-    return m_DataRoot && !m_DataRoot->children.empty();
+    return parentItem && parentItem->childCount != 0;
   }
 
-  const auto parentItem = static_cast<const Item*>(parent.internalPointer());
   return parentItem ? parentItem->group.has_value() : false;
 }
 
 int PluginRecordModel::rowCount(const QModelIndex& parent) const
 {
-  const auto parentItem =
-      parent.isValid() ? static_cast<Item*>(parent.internalPointer()) : m_DataRoot;
-
-  return parentItem ? static_cast<int>(parentItem->children.size()) : 0;
+  const auto parentItem = itemAt(parent);
+  return parentItem ? static_cast<int>(parentItem->childCount) : 0;
 }
 
 int PluginRecordModel::columnCount([[maybe_unused]] const QModelIndex& parent) const
@@ -114,16 +119,15 @@ bool PluginRecordModel::canFetchMore(const QModelIndex& parent) const
     return false;
   }
 
-  const auto parentItem = static_cast<const Item*>(parent.internalPointer());
-  return parentItem && parentItem->group.has_value() && parentItem->children.empty();
+  const auto parentItem = itemAt(parent);
+  return parentItem && parentItem->group.has_value() && parentItem->childCount == 0;
 }
 
 void PluginRecordModel::fetchMore(const QModelIndex& parent)
 {
-  const auto parentItem =
-      parent.isValid() ? static_cast<Item*>(parent.internalPointer()) : nullptr;
+  const auto parentItem = parent.isValid() ? itemAt(parent) : nullptr;
 
-  if (!parentItem || !parentItem->children.empty() || !parentItem->group.has_value()) {
+  if (!parentItem || parentItem->childCount != 0 || !parentItem->group.has_value()) {
     return;
   }
 
@@ -137,6 +141,13 @@ void PluginRecordModel::fetchMore(const QModelIndex& parent)
     names.append(m_PluginName);
   }
 
+  // records are added below, so they are counted again once they are loaded
+  m_PluginList->cancelConflicts();
+
+  const auto path       = getPath(parent);
+  const auto childGroup =
+      parentItem->record ? std::optional(parentItem->group->type()) : std::nullopt;
+
   for (const auto& name : names) {
     const auto vfsEntry =
         m_Organizer->virtualFileTree()->find(name, MOBase::FileTreeEntry::FILE);
@@ -144,16 +155,26 @@ void PluginRecordModel::fetchMore(const QModelIndex& parent)
     const auto filePath = m_Organizer->resolvePath(name);
 
     try {
-      TESData::BranchConflictParser handler{m_PluginList, name.toStdString(),
-                                            getPath(parent)};
+      const auto pluginName = name.toStdString();
+      const auto fsPath     = std::filesystem::path(filePath.toStdWString());
+
+      TESData::BranchConflictParser handler{m_PluginList, pluginName, path};
       TESFile::Reader<TESData::BranchConflictParser> reader{};
-      reader.parse(std::filesystem::path(filePath.toStdWString()), handler);
+      if (const auto location =
+              m_PluginList->locate(pluginName, fsPath, path, childGroup)) {
+        reader.parse(fsPath, *location, handler);
+      } else {
+        reader.parse(fsPath, handler);
+      }
     } catch (const std::exception& e) {
       MOBase::log::error("Error parsing \"{}\": {}", filePath, e.what());
     }
   }
 
-  if (parentItem->children.empty()) {
+  m_PluginList->finalizeEntries();
+  m_PluginList->computeConflicts();
+
+  if (parentItem->childCount == 0) {
     beginRemoveRows(parent, 0, 0);
     parentItem->group = std::nullopt;
     endRemoveRows();
@@ -162,7 +183,7 @@ void PluginRecordModel::fetchMore(const QModelIndex& parent)
 
 QVariant PluginRecordModel::data(const QModelIndex& index, int role) const
 {
-  const auto item = static_cast<const Item*>(index.internalPointer());
+  const Item* const item = itemAt(index);
 
   switch (role) {
   case Qt::DisplayRole:
@@ -177,7 +198,7 @@ QVariant PluginRecordModel::data(const QModelIndex& index, int role) const
               m_PluginList ? m_PluginList->getPluginByName(m_PluginName) : nullptr;
 
           if (plugin) {
-            const auto file       = item->record->file();
+            const auto& file      = item->record->fileName();
             const auto localIndex = std::distance(
                 std::begin(plugin->masters()),
                 TESFile::find(plugin->masters(), file, &QString::toStdString));
@@ -186,7 +207,9 @@ QVariant PluginRecordModel::data(const QModelIndex& index, int role) const
 
           QString str = u"%1"_s.arg(formId, 8, 16, QChar(u'0')).toUpper();
 
-          for (const Item* p = item->parent; p; p = p->parent) {
+          for (auto parent = item->parent; parent != TESData::FileEntry::NoItem;
+               parent      = m_FileEntry->item(parent)->parent) {
+            const auto p = m_FileEntry->item(parent);
             if (p->group && p->group->hasFormType()) {
               if (item->formType != p->group->formType()) {
                 QString suffix = TESData::getFormName(item->formType).toString();
@@ -203,7 +226,8 @@ QVariant PluginRecordModel::data(const QModelIndex& index, int role) const
           return str;
 
         } else if (item->record->hasEditorId()) {
-          return QString::fromStdString(item->record->editorId());
+          const auto editorId = item->record->editorId();
+          return QString::fromUtf8(editorId.data(), editorId.size());
 
         } else if (item->record->hasTypeId()) {
           const auto type    = item->record->typeId();
@@ -226,15 +250,14 @@ QVariant PluginRecordModel::data(const QModelIndex& index, int role) const
 
     case COL_OWNER: {
       if (item->record && item->record->hasFormId()) {
-        const auto file = item->record->file();
-        return QString::fromStdString(file);
+        return QString::fromStdString(item->record->fileName());
       }
       return QVariant();
     }
 
     case COL_NAME: {
       if (item->record && item->record->hasFormId()) {
-        return QString::fromStdString(item->name);
+        return QString::fromUtf8(item->name.data(), item->name.size());
       }
       return QVariant();
     }
@@ -253,27 +276,21 @@ QVariant PluginRecordModel::data(const QModelIndex& index, int role) const
       return QVariant();
     }
 
-    bool isConflicted = false;
-    for (const auto alternative : item->record->alternatives()) {
-      const auto altEntry = m_PluginList->findEntryByHandle(alternative);
-      if (!altEntry || altEntry == m_FileEntry)
-        continue;
-
-      const auto altInfo =
-          m_PluginList->getPluginByName(QString::fromStdString(altEntry->name()));
-      if (!altInfo || !altInfo->enabled())
-        continue;
-
-      isConflicted = true;
-      if (altInfo->priority() > info->priority()) {
-        return QColor(255, 0, 0, 64);
-      }
+    // the plugin shown does not conflict with itself
+    const auto winner     = m_PluginList->recordWinner(*item->record);
+    const bool ownEnabled =
+        info->enabled() &&
+        std::ranges::binary_search(item->record->alternatives(), info->handle());
+    if (winner.enabledCount <= (ownEnabled ? 1 : 0)) {
+      return QVariant();
     }
 
-    if (isConflicted) {
-      return QColor(0, 255, 0, 64);
+    const auto winnerInfo =
+        m_PluginList->getPlugin(m_PluginList->getIndexByHandle(winner.handle));
+    if (winnerInfo && winnerInfo->priority() > info->priority()) {
+      return QColor(255, 0, 0, 64);
     } else {
-      return QVariant();
+      return QColor(0, 255, 0, 64);
     }
   }
 
@@ -46,13 +46,15 @@ public:
 private:
   using Item = TESData::FileEntry::TreeItem;
 
+  // Returns the item for the index, or the root item for an invalid index
+  [[nodiscard]] Item* itemAt(const QModelIndex& index) const;
+
   static QString makeGroupName(TESFile::GroupData group);
 
   QString m_PluginName;
   MOBase::IOrganizer* m_Organizer   = nullptr;
   TESData::PluginList* m_PluginList = nullptr;
   TESData::FileEntry* m_FileEntry   = nullptr;
-  Item* m_DataRoot                  = nullptr;
 };
 
 }  // namespace BSPluginInfo
@@ -108,8 +108,11 @@ void PluginRecordView::onRecordPicked(const QModelIndex& current)
 
   const auto sourceIndex = m_FilterProxy->mapToSource(current);
   if (m_ConflictEntry) {
-    const auto path   = m_RecordModel->getPath(sourceIndex);
-    const auto record = m_ConflictEntry->findRecord(path).get();
+    const auto path = m_RecordModel->getPath(sourceIndex);
+    const auto record =
+        path.hasFormId()
+            ? m_PluginList->findRecord(path.files()[path.formId() >> 24], path.formId())
+            : m_ConflictEntry->findRecord(path);
     if (record) {
       m_StructureModel =
           new RecordStructureModel(m_PluginList, record, path, m_Organizer);
@@ -193,18 +196,13 @@ void PluginRecordView::on_pickRecordView_customContextMenuRequested(const QPoint
 
   QAction* ignoreRecord;
   ignoreRecord = menu.addAction(tr("Ignore Record"), [&] {
+    m_PluginList->cancelConflicts();
+
     for (auto&& item : items) {
       item->record->setIgnored(ignoreRecord->isChecked());
-
-      for (const auto handle : item->record->alternatives()) {
-        const auto entry = m_PluginList->findEntryByHandle(handle);
-        const auto info =
-            m_PluginList->getPluginByName(QString::fromStdString(entry->name()));
-        if (info) {
-          info->invalidateConflicts();
-        }
-      }
     }
+
+    m_PluginList->computeConflicts();
   });
 
   ignoreRecord->setCheckable(true);
@@ -87,27 +87,39 @@ bool RecordFilterProxyModel::filterAcceptsRow(int source_row,
 
   bool isConflicted = false;
   bool isLosing     = false;
-  for (const auto alternative : item->record->alternatives()) {
-    const auto altEntry = m_PluginList->findEntryByHandle(alternative);
-    if (!altEntry || altEntry->name() == m_PluginName.toStdString())
-      continue;
-
-    const auto altInfo =
-        m_PluginList->getPluginByName(QString::fromStdString(altEntry->name()));
-    if (!altInfo || !altInfo->enabled())
-      continue;
-
-    if (info->priority() > altInfo->priority()) {
-      if (!ignoreMasters ||
-          !info->masters().contains(altInfo->name(), Qt::CaseInsensitive)) {
-        isConflicted = true;
-      }
-    } else {
-      if (!ignoreMasters ||
-          !altInfo->masters().contains(info->name(), Qt::CaseInsensitive)) {
-        isConflicted = true;
-        isLosing     = true;
-        break;
+  if (!ignoreMasters) {
+    // the plugin shown does not conflict with itself
+    const auto winner     = m_PluginList->recordWinner(*item->record);
+    const bool ownEnabled =
+        info->enabled() &&
+        std::ranges::binary_search(item->record->alternatives(), info->handle());
+    if (winner.enabledCount > (ownEnabled ? 1 : 0)) {
+      const auto winnerInfo =
+          m_PluginList->getPlugin(m_PluginList->getIndexByHandle(winner.handle));
+      isConflicted = true;
+      isLosing     = winnerInfo && winnerInfo->priority() > info->priority();
+    }
+  } else {
+    // conflicts with masters are left out, so the winner alone is not enough
+    for (const auto alternative : item->record->alternatives()) {
+      if (alternative == info->handle())
+        continue;
+
+      const int altIndex = m_PluginList->getIndexByHandle(alternative);
+      const auto altInfo = altIndex != -1 ? m_PluginList->getPlugin(altIndex) : nullptr;
+      if (!altInfo || !altInfo->enabled())
+        continue;
+
+      if (info->priority() > altInfo->priority()) {
+        if (!info->hasMaster(alternative)) {
+          isConflicted = true;
+        }
+      } else {
+        if (!altInfo->hasMaster(info->handle())) {
+          isConflicted = true;
+          isLosing     = true;
+          break;
+        }
       }
     }
   }
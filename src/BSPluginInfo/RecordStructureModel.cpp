@@ -51,9 +51,14 @@ void RecordStructureModel::readFile(const TESData::RecordPath& path,
 try {
   const auto fileName = QFileInfo(filePath).fileName().toStdString();
   const auto gameName = m_Organizer->managedGame()->gameName();
+  const auto fsPath   = std::filesystem::path(filePath.toStdWString());
   TESData::SingleRecordParser handler(gameName, path, fileName, m_Root.get(), index);
   TESFile::Reader<TESData::SingleRecordParser> reader{};
-  reader.parse(std::filesystem::path(filePath.toStdWString()), handler);
+  if (const auto location = m_PluginList->locate(fileName, fsPath, path)) {
+    reader.parse(fsPath, *location, handler);
+  } else {
+    reader.parse(fsPath, handler);
+  }
 } catch (const std::exception& e) {
   MOBase::log::error("Error parsing \"{}\": {}", filePath, e.what());
 }
@@ -13,7 +13,14 @@
 namespace BSPluginList
 {
 
-PluginListModel::PluginListModel(TESData::PluginList* plugins) : m_Plugins{plugins} {}
+PluginListModel::PluginListModel(TESData::PluginList* plugins) : m_Plugins{plugins}
+{
+  connect(m_Plugins, &TESData::PluginList::conflictsComputed, this, [this] {
+    emit dataChanged(index(0, COL_CONFLICTS), index(rowCount() - 1, COL_CONFLICTS),
+                     {ConflictsIconRole, OverridingRole, OverriddenRole,
+                      OverwritingAuxRole, OverwrittenAuxRole});
+  });
+}
 
 QModelIndex PluginListModel::index(int row, int column,
                                    [[maybe_unused]] const QModelIndex& parent) const
@@ -714,10 +721,7 @@ void PluginListModel::invalidate()
 
 void PluginListModel::invalidateConflicts()
 {
-  for (int i = 0, count = m_Plugins->pluginCount(); i < count; ++i) {
-    const auto plugin = m_Plugins->getPlugin(i);
-    plugin->invalidateConflicts();
-  }
+  m_Plugins->invalidateConflicts();
 
   emit dataChanged(index(0, COL_CONFLICTS), index(rowCount() - 1, COL_CONFLICTS),
                    {PluginListModel::ConflictsIconRole});
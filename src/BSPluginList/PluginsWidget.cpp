@@ -59,6 +59,8 @@ PluginsWidget::PluginsWidget(MOBase::IOrganizer* organizer,
           &PluginListView::updateOverwriteMarkers);
   connect(m_PluginListModel, &QAbstractItemModel::modelReset, ui->pluginList,
           &PluginListView::clearOverwriteMarkers);
+  connect(m_PluginList, &TESData::PluginList::conflictsComputed, ui->pluginList,
+          &PluginListView::updateOverwriteMarkers);
 
   connect(m_PluginListModel, &PluginListModel::pluginStatesChanged, this,
           &PluginsWidget::updatePluginCount);
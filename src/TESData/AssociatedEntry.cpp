@@ -1,17 +1,20 @@
 #include "AssociatedEntry.h"
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace TESData
 {
 
-AuxItem::AuxItem(const std::string& name, const AuxItem* parent)
-    : m_Name{name}, m_Parent{parent}
+AuxItem::AuxItem(const std::string& name, std::shared_ptr<const FreezeState> freeze,
+                 const AuxItem* parent)
+    : m_Name{name}, m_Parent{parent}, m_Freeze{std::move(freeze)}
 {}
 
 std::shared_ptr<AuxItem> AuxItem::getByIndex(int index) const
 {
-  std::shared_lock lk{m_Mutex};
+  const auto lk = m_Freeze->readLock(m_Mutex);
 
   if (index < 0 || index >= m_Children.size()) {
     return nullptr;
@@ -22,7 +25,7 @@ std::shared_ptr<AuxItem> AuxItem::getByIndex(int index) const
 
 std::shared_ptr<AuxItem> AuxItem::getByName(const std::string& name) const
 {
-  std::shared_lock lk{m_Mutex};
+  const auto lk = m_Freeze->readLock(m_Mutex);
 
   const auto it = m_Children.find(name);
   if (it == m_Children.end()) {
@@ -34,7 +37,7 @@ std::shared_ptr<AuxItem> AuxItem::getByName(const std::string& name) const
 
 int AuxItem::indexOf(const AuxItem* item) const
 {
-  std::shared_lock lk{m_Mutex};
+  const auto lk = m_Freeze->readLock(m_Mutex);
 
   const auto it = std::ranges::find(m_Children, item, [&](auto&& pair) {
     return pair.second.get();
@@ -48,21 +51,22 @@ std::shared_ptr<AuxItem> AuxItem::insert(const std::string& name)
   std::unique_lock lk{m_Mutex};
 
   const auto [it, inserted] =
-      m_Children.try_emplace(name, std::make_shared<AuxItem>(name, this));
+      m_Children.try_emplace(name, std::make_shared<AuxItem>(name, m_Freeze, this));
   return it->second;
 }
 
-std::shared_ptr<AuxMember> AuxItem::createMember(const std::string& path)
+std::shared_ptr<AuxMember> AuxItem::createMember(const std::string& path,
+                                                 TESFileHandle origin)
 {
   std::unique_lock lk{m_Mutex};
 
   auto& item = m_Member;
-  if (item != nullptr) {
-    return item;
+  if (item == nullptr) {
+    item       = std::make_shared<AuxMember>();
+    item->path = path;
   }
 
-  item       = std::make_shared<AuxMember>();
-  item->path = path;
+  item->alternatives.insert(origin);
   return item;
 }
 
@@ -72,7 +76,8 @@ void AuxItem::setMember(std::shared_ptr<AuxMember> item)
 }
 
 AssociatedEntry::AssociatedEntry(const std::string& rootName)
-    : m_Root{std::make_shared<AuxItem>(rootName)}
+    : m_Freeze{std::make_shared<FreezeState>()},
+      m_Root{std::make_shared<AuxItem>(rootName, m_Freeze)}
 {}
 
 void AssociatedEntry::forEachMember(
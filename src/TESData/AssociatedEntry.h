@@ -1,9 +1,9 @@
 #ifndef TESDATA_ASSOCIATEDENTRY_H
 #define TESDATA_ASSOCIATEDENTRY_H
 
-#include <boost/container/flat_map.hpp>
+#include "FreezeState.h"
 
-#include <QString>
+#include <boost/container/flat_map.hpp>
 
 #include <functional>
 #include <memory>
@@ -27,7 +27,8 @@ struct AuxMember
 class AuxItem final
 {
 public:
-  explicit AuxItem(const std::string& name, const AuxItem* parent = nullptr);
+  AuxItem(const std::string& name, std::shared_ptr<const FreezeState> freeze,
+          const AuxItem* parent = nullptr);
 
   [[nodiscard]] const std::string& name() const { return m_Name; }
   [[nodiscard]] const AuxItem* parent() const { return m_Parent; }
@@ -39,7 +40,10 @@ public:
   std::shared_ptr<AuxItem> insert(const std::string& name);
 
   [[nodiscard]] const auto& member() const { return m_Member; }
-  std::shared_ptr<AuxMember> createMember(const std::string& path);
+  // Returns the member of this item, creating it if needed, and adds `origin` to its
+  // alternatives
+  std::shared_ptr<AuxMember> createMember(const std::string& path,
+                                          TESFileHandle origin);
   void setMember(std::shared_ptr<AuxMember> item);
 
 private:
@@ -47,6 +51,7 @@ private:
   const AuxItem* m_Parent;
   cont::flat_map<std::string, std::shared_ptr<AuxItem>> m_Children;
   std::shared_ptr<AuxMember> m_Member;
+  std::shared_ptr<const FreezeState> m_Freeze;
   mutable std::shared_mutex m_Mutex;
 };
 
@@ -61,7 +66,13 @@ public:
   void forEachMember(
       std::function<void(const std::shared_ptr<const AuxMember>&)> func) const;
 
+  // See FreezeState. Archives are only read during a scan, so a frozen entry is not
+  // changed until it is thawed.
+  void freeze() { m_Freeze->freeze(); }
+  void thaw() { m_Freeze->thaw(); }
+
 private:
+  std::shared_ptr<FreezeState> m_Freeze;
   std::shared_ptr<AuxItem> m_Root;
 };
 
@@ -9,91 +9,114 @@ namespace TESData
 BranchConflictParser::BranchConflictParser(PluginList* pluginList,
                                            const std::string& pluginName,
                                            const RecordPath& path)
-    : m_PluginList{pluginList}, m_PluginName{pluginName}, m_Path{path}
+    : m_PluginList{pluginList}, m_PluginId{FileNames::intern(pluginName)}, m_Path{path}
 {}
 
-bool BranchConflictParser::Group(TESFile::GroupData group)
+TESFile::Traversal BranchConflictParser::Group(TESFile::GroupData group)
 {
+  if (m_BranchClosed) {
+    return TESFile::Traversal::Stop;
+  }
+
   if (m_CurrentPath.groups().size() < m_Path.groups().size()) {
     const auto& lastGroup = m_Path.groups()[m_CurrentPath.groups().size()];
     if (group.type() != lastGroup.type()) {
-      return false;
+      return TESFile::Traversal::Skip;
     }
 
     if (group.hasParent()) {
       const std::uint8_t localIndex = group.parent() >> 24U;
-      const std::string& owner =
-          localIndex < m_Masters.size() ? m_Masters[localIndex] : m_PluginName;
+      const FileId owner =
+          localIndex < m_Masters.size() ? m_Masters[localIndex] : m_PluginId;
 
-      if (!TESFile::iequals(owner, m_Path.files()[lastGroup.parent() >> 24])) {
-        return false;
+      if (owner != m_Path.files()[lastGroup.parent() >> 24]) {
+        return TESFile::Traversal::Skip;
       }
     } else if (group != lastGroup) {
-      return false;
+      return TESFile::Traversal::Skip;
     }
   } else {
     if (group.hasParent() && m_Path.hasFormId()) {
       if ((group.parent() & 0xFFFFFF) != (m_Path.formId() & 0xFFFFFF)) {
-        return false;
+        return TESFile::Traversal::Skip;
       }
 
       const std::uint8_t localIndex = group.parent() >> 24U;
-      const std::string& owner =
-          localIndex < m_Masters.size() ? m_Masters[localIndex] : m_PluginName;
+      const FileId owner =
+          localIndex < m_Masters.size() ? m_Masters[localIndex] : m_PluginId;
 
-      if (!TESFile::iequals(owner.data(), m_Path.files()[m_Path.formId() >> 24])) {
-        return false;
+      if (owner != m_Path.files()[m_Path.formId() >> 24]) {
+        return TESFile::Traversal::Skip;
       }
     }
   }
 
-  m_CurrentPath.push(group, m_Masters, m_PluginName);
-  return true;
+  m_CurrentPath.push(group, m_Masters, m_PluginId);
+  return TESFile::Traversal::Descend;
 }
 
 void BranchConflictParser::EndGroup()
 {
+  // the children of a record, and a group without a parent, occur only once per file
+  const std::size_t depth = m_CurrentPath.groups().size();
+  if (m_Path.hasFormId()) {
+    if (depth == m_Path.groups().size() + 1 &&
+        m_CurrentPath.groups().back().hasParent()) {
+      m_BranchClosed = true;
+    }
+  } else if (depth == m_Path.groups().size() && !m_Path.groups().back().hasParent()) {
+    m_BranchClosed = true;
+  }
+
   m_CurrentPath.pop();
 }
 
-bool BranchConflictParser::Form(TESFile::FormData form)
+TESFile::Traversal BranchConflictParser::Form(TESFile::FormData form)
 {
+  if (m_BranchClosed) {
+    return TESFile::Traversal::Stop;
+  }
+
   m_CurrentType = form.type();
 
   if (m_CurrentPath.groups().empty()) {
-    return form.type() == "TES4"_ts;
+    return form.type() == "TES4"_ts ? TESFile::Traversal::Descend
+                                    : TESFile::Traversal::Skip;
   }
 
   if (m_CurrentPath.groups().size() < m_Path.groups().size()) {
-    return false;
+    return TESFile::Traversal::Skip;
   } else if (m_CurrentPath.groups().size() == m_Path.groups().size()) {
     if (m_Path.hasFormId()) {
       if ((form.formId() & 0xFFFFFF) != (m_Path.formId() & 0xFFFFFF)) {
-        return false;
+        return TESFile::Traversal::Skip;
       }
 
       const std::uint8_t localIndex = form.formId() >> 24U;
-      const std::string& owner =
-          localIndex < m_Masters.size() ? m_Masters[localIndex] : m_PluginName;
+      const FileId owner =
+          localIndex < m_Masters.size() ? m_Masters[localIndex] : m_PluginId;
 
-      if (!TESFile::iequals(owner, m_Path.files()[m_Path.formId() >> 24])) {
-        return false;
+      if (owner != m_Path.files()[m_Path.formId() >> 24]) {
+        return TESFile::Traversal::Skip;
       }
     }
   }
 
-  m_CurrentPath.setFormId(form.formId(), m_Masters, m_PluginName);
+  m_CurrentPath.setFormId(form.formId(), m_Masters, m_PluginId);
+
+  // only the editor ID is read, which is always the first subrecord when present
+  m_FormComplete = true;
 
   const std::uint8_t localModIndex = form.localModIndex();
   const bool isMasterRecord        = localModIndex < m_Masters.size();
-  return isMasterRecord;
+  return isMasterRecord ? TESFile::Traversal::Descend : TESFile::Traversal::Skip;
 }
 
 void BranchConflictParser::EndForm()
 {
   if (m_CurrentType != "TES4"_ts && m_CurrentType != "TES3"_ts) {
 
-    m_PluginList->addRecordConflict(m_PluginName, m_CurrentPath, m_CurrentType,
+    m_PluginList->addRecordConflict(m_PluginId, m_CurrentPath, m_CurrentType,
                                     m_CurrentName);
   }
 
@@ -101,6 +124,7 @@ void BranchConflictParser::EndForm()
   m_CurrentType  = {};
   m_CurrentChunk = {};
   m_CurrentName.clear();
+  m_FormComplete = false;
 }
 
 bool BranchConflictParser::Chunk(TESFile::Type type)
@@ -113,19 +137,23 @@ bool BranchConflictParser::Chunk(TESFile::Type type)
   }
 }
 
-void BranchConflictParser::Data(std::istream& stream)
+bool BranchConflictParser::FormComplete() const
+{
+  return m_FormComplete;
+}
+
+void BranchConflictParser::Data(TESFile::Cursor& data)
 {
   switch (m_CurrentChunk) {
   case "MAST"_ts: {
-    const std::string master = TESFile::readZstring(stream);
+    const std::string_view master = TESFile::readZstring(data);
     if (!master.empty()) {
-      m_Masters.push_back(master);
+      m_Masters.push_back(FileNames::intern(master));
     }
   } break;
 
   case "EDID"_ts: {
-    const std::string editorId = TESFile::readZstring(stream);
-    m_CurrentName              = std::move(editorId);
+    m_CurrentName = TESFile::readZstring(data);
   } break;
   }
 }
@@ -3,8 +3,9 @@
 
 #include "PluginList.h"
 #include "RecordPath.h"
+#include "TESFile/Cursor.h"
+#include "TESFile/TypeSet.h"
 
-#include <istream>
 #include <vector>
 
 namespace TESData
@@ -13,26 +14,31 @@ namespace TESData
 class BranchConflictParser final
 {
 public:
+  static constexpr TESFile::TypeSet WantedChunks{"MAST"_ts, "EDID"_ts};
+
   BranchConflictParser(PluginList* pluginList, const std::string& pluginName,
                        const RecordPath& path);
 
-  bool Group(TESFile::GroupData group);
+  TESFile::Traversal Group(TESFile::GroupData group);
   void EndGroup();
-  bool Form(TESFile::FormData form);
+  TESFile::Traversal Form(TESFile::FormData form);
   void EndForm();
   bool Chunk(TESFile::Type type);
-  void Data(std::istream& stream);
+  void Data(TESFile::Cursor& data);
+  bool FormComplete() const;
 
 private:
   PluginList* m_PluginList;
-  std::string m_PluginName;
+  FileId m_PluginId;
   TESData::RecordPath m_Path;
 
-  std::vector<std::string> m_Masters;
+  std::vector<FileId> m_Masters;
   RecordPath m_CurrentPath;
   TESFile::Type m_CurrentType;
   TESFile::Type m_CurrentChunk;
   std::string m_CurrentName;
+  bool m_FormComplete = false;
+  bool m_BranchClosed = false;
 };
 
 }  // namespace TESData
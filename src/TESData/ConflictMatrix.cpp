@@ -0,0 +1,113 @@
+#include "ConflictMatrix.h"
+
+#include <algorithm>
+#include <future>
+#include <unordered_map>
+
+namespace TESData
+{
+
+// Overlaps keyed by the pair of handles, the lower one in the upper half
+using PairCounts = std::unordered_map<std::uint64_t, ConflictMatrix::Overlap>;
+
+static std::uint64_t pairKey(TESFileHandle lhs, TESFileHandle rhs)
+{
+  const auto [low, high] = std::minmax(lhs, rhs);
+  return (static_cast<std::uint64_t>(low) << 32U) | static_cast<std::uint32_t>(high);
+}
+
+static void countRecords(PairCounts& counts, const FileEntry& entry)
+{
+  entry.forEachRecord([&](const Record& record) {
+    const auto alternatives = record.alternatives();
+
+    // each record is counted once, in the entry of its first alternative
+    if (alternatives.size() < 2 || alternatives.front() != entry.handle() ||
+        record.ignored()) {
+      return;
+    }
+
+    for (std::size_t i = 0; i < alternatives.size(); ++i) {
+      for (std::size_t j = i + 1; j < alternatives.size(); ++j) {
+        ++counts[pairKey(alternatives[i], alternatives[j])].records;
+      }
+    }
+  });
+}
+
+std::shared_ptr<const ConflictMatrix>
+ConflictMatrix::build(std::span<const std::shared_ptr<FileEntry>> entries,
+                      const AssociatedEntry& archives, unsigned concurrency,
+                      const std::atomic<bool>& cancelled)
+{
+  std::atomic<std::size_t> next = 0;
+  const auto work = [&] {
+    PairCounts counts;
+    for (std::size_t i = next++; i < entries.size() && !cancelled; i = next++) {
+      countRecords(counts, *entries[i]);
+    }
+    return counts;
+  };
+
+  std::vector<std::future<PairCounts>> workers;
+  for (unsigned i = 1; i < concurrency; ++i) {
+    workers.push_back(std::async(std::launch::async, work));
+  }
+
+  PairCounts counts = work();
+  for (auto& worker : workers) {
+    for (const auto& [key, overlap] : worker.get()) {
+      counts[key].records += overlap.records;
+    }
+  }
+
+  if (cancelled) {
+    return nullptr;
+  }
+
+  archives.forEachMember([&](const std::shared_ptr<const AuxMember>& member) {
+    const auto& alternatives = member->alternatives;
+    for (auto it = alternatives.begin(); it != alternatives.end(); ++it) {
+      for (auto other = std::next(it); other != alternatives.end(); ++other) {
+        ++counts[pairKey(*it, *other)].archiveFiles;
+      }
+    }
+  });
+
+  auto matrix = std::make_shared<ConflictMatrix>();
+  for (const auto& [key, overlap] : counts) {
+    const auto low  = static_cast<TESFileHandle>(key >> 32U);
+    const auto high = static_cast<TESFileHandle>(key & 0xFFFFFFFFU);
+    // pairs are only made of valid handles, which are not negative
+    if (static_cast<std::size_t>(high) >= matrix->m_Rows.size()) {
+      matrix->m_Rows.resize(high + 1);
+    }
+
+    matrix->m_Rows[low].emplace_back(high, overlap);
+    matrix->m_Rows[high].emplace_back(low, overlap);
+  }
+
+  for (auto& row : matrix->m_Rows) {
+    std::ranges::sort(row, {}, &Row::value_type::first);
+  }
+
+  return matrix;
+}
+
+const ConflictMatrix::Row& ConflictMatrix::row(TESFileHandle handle) const
+{
+  static const Row empty;
+  return handle >= 0 && static_cast<std::size_t>(handle) < m_Rows.size()
+             ? m_Rows[handle]
+             : empty;
+}
+
+ConflictMatrix::Overlap ConflictMatrix::overlap(TESFileHandle lhs,
+                                                TESFileHandle rhs) const
+{
+  const auto& lhsRow = row(lhs);
+  const auto it = std::ranges::lower_bound(lhsRow, rhs, {}, &Row::value_type::first);
+  return it != lhsRow.end() && it->first == rhs ? it->second : Overlap{};
+}
+
+}  // namespace TESData
@@ -0,0 +1,49 @@
+#ifndef TESDATA_CONFLICTMATRIX_H
+#define TESDATA_CONFLICTMATRIX_H
+
+#include "AssociatedEntry.h"
+#include "FileEntry.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace TESData
+{
+
+// Number of records and archive files that each pair of plugins both provide. Only
+// pairs that share something are stored, in a row per entry handle.
+class ConflictMatrix final
+{
+public:
+  struct Overlap
+  {
+    std::uint32_t records      = 0;
+    std::uint32_t archiveFiles = 0;
+  };
+
+  // Plugins overlapping with one plugin, sorted by handle
+  using Row = std::vector<std::pair<TESFileHandle, Overlap>>;
+
+  // Counts the records shared through the alternatives of the records in `entries`,
+  // on up to `concurrency` threads, and the archive files shared through the members
+  // of `archives`. Ignored records are left out. Returns nothing if `cancelled` is
+  // set before the count is complete.
+  static std::shared_ptr<const ConflictMatrix>
+  build(std::span<const std::shared_ptr<FileEntry>> entries,
+        const AssociatedEntry& archives, unsigned concurrency,
+        const std::atomic<bool>& cancelled);
+
+  [[nodiscard]] const Row& row(TESFileHandle handle) const;
+  [[nodiscard]] Overlap overlap(TESFileHandle lhs, TESFileHandle rhs) const;
+
+private:
+  std::vector<Row> m_Rows;
+};
+
+}  // namespace TESData
+
+#endif  // TESDATA_CONFLICTMATRIX_H
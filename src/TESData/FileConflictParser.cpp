@@ -14,14 +14,14 @@ FileConflictParser::FileConflictParser(PluginList* pluginList, FileInfo* plugin,
     : m_PluginList{pluginList}, m_Plugin{plugin}, m_LightSupported{lightSupported},
       m_OverlaySupported{overlaySupported}
 {
-  m_PluginName = m_Plugin->name().toStdString();
+  m_PluginId = FileNames::intern(m_Plugin->name().toStdString());
 }
 
 bool FileConflictParser::Group(TESFile::GroupData group)
 {
   if (group.hasDirectParent()) {
-    m_CurrentPath.push(group, m_Masters, m_PluginName);
-    m_PluginList->addGroupPlaceholder(m_PluginName, m_CurrentPath);
+    m_CurrentPath.push(group, m_Masters, m_PluginId);
+    m_PluginList->addGroupPlaceholder(m_PluginId, m_CurrentPath);
     m_CurrentPath.pop();
     return false;
   }
@@ -35,7 +35,7 @@ bool FileConflictParser::Group(TESFile::GroupData group)
     return false;
   }
 
-  m_CurrentPath.push(group, m_Masters, m_PluginName);
+  m_CurrentPath.push(group, m_Masters, m_PluginId);
   return true;
 }
 
@@ -63,12 +63,16 @@ bool FileConflictParser::Form(TESFile::FormData form)
     }
   }
 
+  // other than default objects, only the editor ID is read, which is always the first
+  // subrecord when present
+  m_FormComplete = m_CurrentPath.groups().front().formType() != "DOBJ"_ts;
+
   switch (m_CurrentPath.groups().front().formType()) {
   case "DOBJ"_ts:
   case "GMST"_ts:
     return true;
   default:
-    m_CurrentPath.setFormId(form.formId(), m_Masters, m_PluginName);
+    m_CurrentPath.setFormId(form.formId(), m_Masters, m_PluginId);
 
     const int localModIndex   = form.localModIndex();
     const bool isMasterRecord = localModIndex < m_Masters.size();
@@ -81,7 +85,7 @@ void FileConflictParser::EndForm()
   if (m_CurrentType != "TES4"_ts && m_CurrentType != "TES3"_ts &&
       m_CurrentType != "GMST"_ts && m_CurrentType != "DOBJ"_ts) {
 
-    m_PluginList->addRecordConflict(m_PluginName, m_CurrentPath, m_CurrentType,
+    m_PluginList->addRecordConflict(m_PluginId, m_CurrentPath, m_CurrentType,
                                     m_CurrentName);
   }
 
@@ -89,6 +93,7 @@ void FileConflictParser::EndForm()
   m_CurrentType  = {};
   m_CurrentChunk = {};
   m_CurrentName.clear();
+  m_FormComplete = false;
 }
 
 bool FileConflictParser::Chunk(TESFile::Type type)
@@ -118,23 +123,28 @@ bool FileConflictParser::Chunk(TESFile::Type type)
   }
 }
 
-void FileConflictParser::Data(std::istream& stream)
+bool FileConflictParser::FormComplete() const
+{
+  return m_FormComplete;
+}
+
+void FileConflictParser::Data(TESFile::Cursor& data)
 {
   if (m_CurrentPath.groups().empty()) {
-    return MainRecordData(stream);
+    return MainRecordData(data);
   }
 
   switch (m_CurrentPath.groups().front().formType()) {
   case "DOBJ"_ts:
-    return DefaultObjectData(stream);
+    return DefaultObjectData(data);
   case "GMST"_ts:
-    return GameSettingData(stream);
+    return GameSettingData(data);
   default:
-    return StandardData(stream);
+    return StandardData(data);
   }
 }
 
-void FileConflictParser::MainRecordData(std::istream& stream)
+void FileConflictParser::MainRecordData(TESFile::Cursor& data)
 {
   switch (m_CurrentChunk) {
   case "HEDR"_ts: {
@@ -145,47 +155,46 @@ void FileConflictParser::MainRecordData(std::istream& stream)
       uint32_t nextObjectId;
     };
 
-    const auto header = TESFile::readType<Header>(stream);
-    if (stream.fail()) {
+    if (data.remaining() < sizeof(Header)) {
       MOBase::log::error("failed to read HEDR data");
       return;
     }
+    const auto header = TESFile::readType<Header>(data);
 
     m_Plugin->setHasNoRecords(header.numRecords == 0);
   } break;
 
   case "MAST"_ts: {
-    const std::string master = TESFile::readZstring(stream);
+    const std::string master{TESFile::readZstring(data)};
     if (!master.empty()) {
-      m_Plugin->addMaster(QString::fromStdString(master.c_str()));
-      m_Masters.push_back(master);
+      m_Plugin->addMaster(QString::fromStdString(master));
+      m_Masters.push_back(FileNames::intern(master));
     }
   } break;
 
   case "CNAM"_ts: {
-    const std::string author = TESFile::readZstring(stream);
+    const std::string_view author = TESFile::readZstring(data);
     if (!author.empty()) {
-      m_Plugin->setAuthor(QString::fromLatin1(author.data()));
+      m_Plugin->setAuthor(QString::fromLatin1(author));
     }
   } break;
 
   case "SNAM"_ts: {
-    const std::string desc = TESFile::readZstring(stream);
+    const std::string_view desc = TESFile::readZstring(data);
     if (!desc.empty()) {
-      m_Plugin->setDescription(QString::fromLatin1(desc.data()));
+      m_Plugin->setDescription(QString::fromLatin1(desc));
     }
   } break;
   }
 }
 
-void FileConflictParser::DefaultObjectData(std::istream& stream)
+void FileConflictParser::DefaultObjectData(TESFile::Cursor& data)
 {
   switch (m_CurrentChunk) {
   case "DNAM"_ts:
-    while (stream.peek() != std::char_traits<char>::eof()) {
-      const TESFile::Type name = TESFile::readType<TESFile::Type>(stream);
-      [[maybe_unused]] const std::uint32_t formId =
-          TESFile::readType<std::uint32_t>(stream);
+    while (!data.atEnd()) {
+      const TESFile::Type name = TESFile::readType<TESFile::Type>(data);
+      [[maybe_unused]] const std::uint32_t formId = TESFile::readFormId(data);
       if (name == TESFile::Type()) {
         continue;
       }
@@ -193,29 +202,28 @@ void FileConflictParser::DefaultObjectData(std::istream& stream)
         break;
       }
       m_CurrentPath.setTypeId(name);
-      m_PluginList->addRecordConflict(m_PluginName, m_CurrentPath, "DOBJ"_ts, "");
+      m_PluginList->addRecordConflict(m_PluginId, m_CurrentPath, "DOBJ"_ts, "");
     }
     break;
   }
 }
 
-void FileConflictParser::GameSettingData(std::istream& stream)
+void FileConflictParser::GameSettingData(TESFile::Cursor& data)
 {
   switch (m_CurrentChunk) {
   case "EDID"_ts: {
-    const std::string editorId = TESFile::readZstring(stream);
+    const std::string editorId{TESFile::readZstring(data)};
     m_CurrentPath.setEditorId(editorId);
-    m_PluginList->addRecordConflict(m_PluginName, m_CurrentPath, "GMST"_ts, "");
+    m_PluginList->addRecordConflict(m_PluginId, m_CurrentPath, "GMST"_ts, "");
   } break;
   }
 }
 
-void FileConflictParser::StandardData(std::istream& stream)
+void FileConflictParser::StandardData(TESFile::Cursor& data)
 {
   switch (m_CurrentChunk) {
   case "EDID"_ts: {
-    const std::string editorId = TESFile::readZstring(stream);
-    m_CurrentName              = std::move(editorId);
+    m_CurrentName = TESFile::readZstring(data);
   } break;
   }
 }
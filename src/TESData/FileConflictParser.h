@@ -2,7 +2,9 @@
 #define TESDATA_FILECONFLICTPARSER_H
 
 #include "RecordPath.h"
+#include "TESFile/Cursor.h"
 #include "TESFile/Stream.h"
+#include "TESFile/TypeSet.h"
 
 #include <string>
 #include <vector>
@@ -16,6 +18,9 @@ class FileInfo;
 class FileConflictParser final
 {
 public:
+  static constexpr TESFile::TypeSet WantedChunks{"HEDR"_ts, "MAST"_ts, "CNAM"_ts,
+                                                 "SNAM"_ts, "DNAM"_ts, "EDID"_ts};
+
   FileConflictParser(PluginList* pluginList, FileInfo* plugin, bool lightSupported,
                     bool overlaySupported);
 
@@ -24,25 +29,27 @@ public:
   bool Form(TESFile::FormData form);
   void EndForm();
   bool Chunk(TESFile::Type type);
-  void Data(std::istream& stream);
+  void Data(TESFile::Cursor& data);
+  bool FormComplete() const;
 
 private:
-  void MainRecordData(std::istream& stream);
-  void DefaultObjectData(std::istream& stream);
-  void GameSettingData(std::istream& stream);
-  void StandardData(std::istream& stream);
+  void MainRecordData(TESFile::Cursor& data);
+  void DefaultObjectData(TESFile::Cursor& data);
+  void GameSettingData(TESFile::Cursor& data);
+  void StandardData(TESFile::Cursor& data);
 
   PluginList* m_PluginList;
   FileInfo* m_Plugin;
   bool m_LightSupported;
   bool m_OverlaySupported;
 
-  std::string m_PluginName;
-  std::vector<std::string> m_Masters;
+  FileId m_PluginId;
+  std::vector<FileId> m_Masters;
   RecordPath m_CurrentPath;
   TESFile::Type m_CurrentType;
   TESFile::Type m_CurrentChunk;
   std::string m_CurrentName;
+  bool m_FormComplete = false;
 };
 
 }  // namespace TESData
@@ -1,79 +1,158 @@
 #include "FileEntry.h"
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
 #include <utility>
+#include <variant>
 
 namespace TESData
 {
 
+static std::size_t hashChild(FileEntry::ItemIndex parent,
+                             const FileEntry::TreeItem::Key& key)
+{
+  const std::size_t keyHash = std::visit(
+      [](auto&& value) -> std::size_t {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, TESFile::GroupData>) {
+          return std::hash<std::uint64_t>{}(
+              (static_cast<std::uint64_t>(value.type()) << 32) | value.parent());
+        } else if constexpr (std::is_same_v<T, TESFile::Type>) {
+          return std::hash<std::uint32_t>{}(static_cast<std::uint32_t>(value));
+        } else {
+          return std::hash<T>{}(value);
+        }
+      },
+      key);
+
+  return keyHash ^ (std::hash<std::uint32_t>{}(parent) * 0x9E3779B97F4A7C15ULL) ^
+         key.index();
+}
+
+std::size_t FileEntry::ChildHash::operator()(ItemIndex index) const
+{
+  const auto& item = (*items)[index];
+  return hashChild(item.parent, item.key);
+}
+
+std::size_t FileEntry::ChildHash::operator()(const ChildKey& key) const
+{
+  return hashChild(key.parent, key.key);
+}
+
+bool FileEntry::ChildEqual::operator()(const ChildKey& lhs, ItemIndex rhs) const
+{
+  const auto& item = (*items)[rhs];
+  return item.parent == lhs.parent && item.key == lhs.key;
+}
+
 FileEntry::FileEntry(TESFileHandle handle, const std::string& name)
-    : m_Handle{handle}, m_Name{name}, m_Root{std::make_shared<TreeItem>()}
-{}
+    : m_Handle{handle}, m_Name{name}, m_Children{0, ChildHash{&m_Items},
+                                                 ChildEqual{&m_Items}}
+{
+  m_Items.emplace_back();
+}
 
-void FileEntry::forEachRecord(
-    std::function<void(const std::shared_ptr<const Record>&)> func) const
+void FileEntry::forEachRecord(std::function<void(const Record&)> func) const
 {
-  std::vector<std::shared_ptr<TreeItem>> stack;
-  stack.push_back(m_Root);
-  while (!stack.empty()) {
-    const auto item = std::move(stack.back());
-    stack.pop_back();
+  const auto lk = m_Freeze.readLock(m_Mutex);
 
-    if (item->record) {
-      func(item->record);
+  for (const auto& item : m_Items) {
+    if (item.record) {
+      func(*item.record);
     }
+  }
+}
 
-    for (const auto& [identifier, child] : item->children) {
-      stack.push_back(child);
-    }
+// Whether `name` should replace the name of an existing record item
+static bool replacesName(const FileEntry::TreeItem& item, const std::string& name,
+                         bool fromOwner)
+{
+  if (item.ownName) {
+    return false;
+  } else if (fromOwner) {
+    return true;
+  } else {
+    return !name.empty() && (item.name.empty() || name < item.name);
   }
 }
 
-std::shared_ptr<Record> FileEntry::createRecord(const RecordPath& path,
-                                                const std::string& name,
-                                                TESFile::Type formType)
+Record* FileEntry::createRecord(const RecordPath& path, const std::string& name,
+                                TESFile::Type formType, bool fromOwner)
 {
-  const auto item = createHierarchy(path);
+  // master records are usually overridden by several plugins, which are scanned in
+  // parallel, so only lock the entry exclusively when the record is new
+  {
+    const auto lk = m_Freeze.readLock(m_Mutex);
+    if (const auto index = findIndex(path); index != NoItem && m_Items[index].record) {
+      const auto& item = m_Items[index];
+      if (!replacesName(item, name, fromOwner)) {
+        return item.record;
+      }
+    }
+  }
 
   std::unique_lock lk{m_Mutex};
 
-  if (!item->record) {
-    item->record = std::make_shared<Record>();
-    lk.unlock();
-
-    item->record->setIdentifier(path.identifier(), path.files());
-    item->record->addAlternative(m_Handle);
-    item->name     = name;
-    item->formType = formType;
+  auto& item = m_Items[createHierarchy(path)];
+  if (!item.record) {
+    createRecord(item)->addAlternative(m_Handle);
+  } else if (!replacesName(item, name, fromOwner)) {
+    return item.record;
   }
 
-  return item->record;
+  item.name     = storeString(name);
+  item.formType = formType;
+  item.ownName  = fromOwner;
+  return item.record;
 }
 
 void FileEntry::addRecord(const RecordPath& path, const std::string& name,
-                          TESFile::Type formType, std::shared_ptr<Record> record)
+                          TESFile::Type formType, Record* record)
 {
   record->addAlternative(m_Handle);
-  const auto item = createHierarchy(path);
-  item->record    = record;
-  item->name      = name;
-  item->formType  = formType;
+
+  {
+    const auto lk = m_Freeze.readLock(m_Mutex);
+    if (const auto index = findIndex(path);
+        index != NoItem && m_Items[index].record == record) {
+      return;
+    }
+  }
+
+  std::unique_lock lk{m_Mutex};
+
+  auto& item    = m_Items[createHierarchy(path)];
+  item.record   = record;
+  item.name     = storeString(name);
+  item.formType = formType;
+  item.ownName  = true;
 }
 
 void FileEntry::addChildGroup(const RecordPath& path)
 {
-  const auto item = findItem(path);
-  if (!item || !item->record) {
+  std::unique_lock lk{m_Mutex};
+
+  const auto index = findIndex(path);
+  if (index == NoItem) {
+    return;
+  }
+
+  auto& item = m_Items[index];
+  if (!item.record) {
     // no record to add children to
     return;
   }
 
   TESFile::GroupData group = path.groups().back();
   if (group.hasParent()) {
-    const auto& file            = path.files()[group.parent() >> 24];
+    const FileId file           = path.files()[group.parent() >> 24];
     const std::uint8_t newIndex = static_cast<std::uint8_t>(
-        std::distance(std::begin(m_Files), TESFile::find(m_Files, file)));
+        std::distance(std::begin(m_Files), std::ranges::find(m_Files, file)));
 
     if (newIndex == m_Files.size()) {
       m_Files.push_back(file);
@@ -82,86 +161,150 @@ void FileEntry::addChildGroup(const RecordPath& path)
     group.setLocalIndex(newIndex);
   }
 
-  item->group = group;
+  item.group = group;
 }
 
-std::shared_ptr<Record> FileEntry::findRecord(const RecordPath& path) const
+void FileEntry::finalize()
+{
+  std::unique_lock lk{m_Mutex};
+
+  if (m_FinalizedItems == m_Items.size()) {
+    return;
+  }
+
+  // the new items are appended to the children their parents already had, so the
+  // list is rebuilt with room for them after each of those ranges
+  std::vector<std::uint32_t> next(m_Items.size(), 0);
+  for (std::size_t i = m_FinalizedItems; i < m_Items.size(); ++i) {
+    ++next[m_Items[i].parent];
+  }
+
+  std::vector<ItemIndex> childList(m_Items.size() - 1);
+  std::uint32_t offset = 0;
+  for (std::size_t i = 0; i < m_Items.size(); ++i) {
+    auto& item = m_Items[i];
+    std::ranges::copy(children(item), childList.begin() + offset);
+
+    const std::uint32_t added = next[i];
+    item.firstChild           = offset;
+    next[i]                   = offset + item.childCount;
+    offset += item.childCount + added;
+  }
+
+  for (std::size_t i = m_FinalizedItems; i < m_Items.size(); ++i) {
+    auto& item   = m_Items[i];
+    auto& parent = m_Items[item.parent];
+    item.row     = parent.childCount++;
+
+    childList[next[item.parent]++] = static_cast<ItemIndex>(i);
+  }
+
+  m_ChildList      = std::move(childList);
+  m_FinalizedItems = m_Items.size();
+
+  std::ranges::sort(m_Unsorted);
+  const auto [last, end] = std::ranges::unique(m_Unsorted);
+  m_Unsorted.erase(last, end);
+
+  for (const auto index : m_Unsorted) {
+    auto& item = m_Items[index];
+    const auto range = std::span(m_ChildList).subspan(item.firstChild, item.childCount);
+    std::ranges::sort(range, [this](ItemIndex lhs, ItemIndex rhs) {
+      return keyLess(m_Items[lhs].key, m_Items[rhs].key);
+    });
+
+    for (std::uint32_t row = 0; row < range.size(); ++row) {
+      m_Items[range[row]].row = row;
+    }
+    item.lastChild = range.back();
+  }
+
+  m_Unsorted.clear();
+}
+
+Record* FileEntry::findRecord(const RecordPath& path) const
 {
   const auto item = findItem(path);
   return item ? item->record : nullptr;
 }
 
-std::shared_ptr<FileEntry::TreeItem> FileEntry::findItem(const RecordPath& path) const
+const FileEntry::TreeItem* FileEntry::findItem(const RecordPath& path) const
 {
-  std::shared_lock lk{m_Mutex};
+  const auto lk = m_Freeze.readLock(m_Mutex);
 
+  const auto index = findIndex(path);
+  return index != NoItem ? &m_Items[index] : nullptr;
+}
+
+FileEntry::ItemIndex FileEntry::findIndex(const RecordPath& path) const
+{
   const auto groups = path.groups();
-  auto item         = m_Root;
+  ItemIndex index   = 0;
   for (TESFile::GroupData group : groups) {
     if (group.hasParent()) {
-      const auto& file            = path.files()[group.parent() >> 24];
+      const FileId file           = path.files()[group.parent() >> 24];
       const std::uint8_t newIndex = static_cast<std::uint8_t>(
-          std::distance(std::begin(m_Files), TESFile::find(m_Files, file)));
+          std::distance(std::begin(m_Files), std::ranges::find(m_Files, file)));
 
       if (newIndex == m_Files.size()) {
-        return nullptr;
+        return NoItem;
       }
 
       group.setLocalIndex(newIndex);
     }
 
+    const auto& item = m_Items[index];
     if (group.hasDirectParent() &&
-        (!item->record || item->record->formId() != group.parent())) {
-      if (const auto it = item->children.find(group.parent());
-          it != item->children.end()) {
-        item = it->second;
-      } else {
-        return nullptr;
-      }
+        (!item.record || item.record->formId() != group.parent())) {
+      index = findChild(index, group.parent());
     } else {
-      if (const auto it = item->children.find(group); it != item->children.end()) {
-        item = it->second;
-      } else {
-        return nullptr;
-      }
+      index = findChild(index, group);
+    }
+
+    if (index == NoItem) {
+      return NoItem;
     }
   }
 
   TreeItem::Key key;
   if (path.hasFormId()) {
-    const auto& file            = path.files()[path.formId() >> 24];
+    const FileId file           = path.files()[path.formId() >> 24];
     const std::uint8_t newIndex = static_cast<std::uint8_t>(
-        std::distance(std::begin(m_Files), TESFile::find(m_Files, file)));
+        std::distance(std::begin(m_Files), std::ranges::find(m_Files, file)));
 
     if (newIndex == m_Files.size()) {
-      return nullptr;
+      return NoItem;
     }
 
     const std::uint32_t formId = (path.formId() & 0xFFFFFFU) | (newIndex << 24U);
     key                        = formId;
   } else if (path.hasEditorId()) {
-    key = path.editorId();
+    key = std::string_view(path.editorId());
   } else if (path.hasTypeId()) {
     key = path.typeId();
   } else {
-    return item;
+    return index;
   }
 
-  const auto it = item->children.find(key);
-  return it != item->children.end() ? it->second : nullptr;
+  return findChild(index, key);
 }
 
-std::shared_ptr<FileEntry::TreeItem> FileEntry::createHierarchy(const RecordPath& path)
+FileEntry::ItemIndex FileEntry::findChild(ItemIndex parent,
+                                          const TreeItem::Key& key) const
 {
-  std::unique_lock lk{m_Mutex};
+  const auto it = m_Children.find(ChildKey{parent, key});
+  return it != m_Children.end() ? *it : NoItem;
+}
 
+FileEntry::ItemIndex FileEntry::createHierarchy(const RecordPath& path)
+{
   const auto groups = path.groups();
-  auto item         = m_Root;
+  ItemIndex index   = 0;
   for (TESFile::GroupData group : groups) {
     if (group.hasParent()) {
-      const auto& file            = path.files()[group.parent() >> 24];
+      const FileId file           = path.files()[group.parent() >> 24];
       const std::uint8_t newIndex = static_cast<std::uint8_t>(
-          std::distance(std::begin(m_Files), TESFile::find(m_Files, file)));
+          std::distance(std::begin(m_Files), std::ranges::find(m_Files, file)));
 
       if (newIndex == m_Files.size()) {
         m_Files.push_back(file);
@@ -170,34 +313,30 @@ std::shared_ptr<FileEntry::TreeItem> FileEntry::createHierarchy(const RecordPath
       group.setLocalIndex(newIndex);
     }
 
+    const auto& item = m_Items[index];
     if (group.hasDirectParent() &&
-        (!item->record || item->record->formId() != group.parent())) {
-      auto& nextItem = item->children[group.parent()];
-      if (!nextItem) {
-        nextItem         = std::make_shared<TreeItem>();
-        nextItem->parent = item.get();
-        nextItem->record = std::make_shared<Record>();
-        nextItem->record->setIdentifier(group.parent(), m_Files);
+        (!item.record || item.record->formId() != group.parent())) {
+      auto [nextItem, created] = getOrCreateChild(index, group.parent());
+      if (created) {
+        createRecord(nextItem);
       }
-      nextItem->group = group;
+      nextItem.group = group;
 
-      item = nextItem;
+      index = nextItem.index;
     } else {
-      auto& nextItem = item->children[group];
-      if (!nextItem) {
-        nextItem         = std::make_shared<TreeItem>();
-        nextItem->parent = item.get();
-        nextItem->group  = group;
+      auto [nextItem, created] = getOrCreateChild(index, group);
+      if (created) {
+        nextItem.group = group;
       }
-      item = nextItem;
+      index = nextItem.index;
     }
   }
 
   TreeItem::Key key;
   if (path.hasFormId()) {
-    const auto& file            = path.files()[path.formId() >> 24];
+    const FileId file           = path.files()[path.formId() >> 24];
     const std::uint8_t newIndex = static_cast<std::uint8_t>(
-        std::distance(std::begin(m_Files), TESFile::find(m_Files, file)));
+        std::distance(std::begin(m_Files), std::ranges::find(m_Files, file)));
 
     if (newIndex == m_Files.size()) {
       m_Files.push_back(file);
@@ -206,20 +345,97 @@ std::shared_ptr<FileEntry::TreeItem> FileEntry::createHierarchy(const RecordPath
     const std::uint32_t formId = (path.formId() & 0xFFFFFFU) | (newIndex << 24U);
     key                        = formId;
   } else if (path.hasEditorId()) {
-    key = path.editorId();
+    key = std::string_view(path.editorId());
   } else if (path.hasTypeId()) {
     key = path.typeId();
   } else {
-    return item;
+    return index;
   }
 
-  auto& recordItem = item->children[key];
-  if (!recordItem) {
-    recordItem         = std::make_shared<TreeItem>();
-    recordItem->parent = item.get();
+  return getOrCreateChild(index, std::move(key)).first.index;
+}
+
+Record* FileEntry::createRecord(TreeItem& item)
+{
+  auto& record = m_Records.emplace_back();
+  if (const auto formId = std::get_if<std::uint32_t>(&item.key)) {
+    record.setFormId(*formId, m_Files);
+  } else if (const auto editorId = std::get_if<std::string_view>(&item.key)) {
+    record.setEditorId(*editorId);
+  } else if (const auto typeId = std::get_if<TESFile::Type>(&item.key)) {
+    record.setTypeId(*typeId);
+  }
+
+  item.record = &record;
+  return item.record;
+}
+
+std::pair<FileEntry::TreeItem&, bool> FileEntry::getOrCreateChild(ItemIndex parent,
+                                                                 TreeItem::Key key)
+{
+  if (const auto it = m_Children.find(ChildKey{parent, key}); it != m_Children.end()) {
+    return {m_Items[*it], false};
+  }
+
+  const auto index = static_cast<ItemIndex>(m_Items.size());
+  auto& child      = m_Items.emplace_back();
+  child.index      = index;
+  child.parent     = parent;
+  child.key        = std::move(key);
+  if (const auto editorId = std::get_if<std::string_view>(&child.key)) {
+    child.key = storeString(*editorId);
+  }
+  m_Children.insert(index);
+
+  // children are appended and only sorted when the entry is finalized, which
+  // records mostly arriving in key order makes unnecessary
+  auto& parentItem = m_Items[parent];
+  if (parentItem.lastChild != NoItem &&
+      keyLess(child.key, m_Items[parentItem.lastChild].key)) {
+    m_Unsorted.push_back(parent);
+  }
+  parentItem.lastChild = index;
+
+  return {child, true};
+}
+
+std::string_view FileEntry::storeString(std::string_view str)
+{
+  static constexpr std::size_t BlockSize = 0x10000;
+
+  if (str.size() > m_StringBlockFree) {
+    const std::size_t size = std::max(str.size(), BlockSize);
+    m_StringBlocks.push_back(std::make_unique_for_overwrite<char[]>(size));
+    m_StringCursor    = m_StringBlocks.back().get();
+    m_StringBlockFree = size;
+  }
+
+  const std::string_view stored{m_StringCursor, str.size()};
+  std::ranges::copy(str, m_StringCursor);
+  m_StringCursor += str.size();
+  m_StringBlockFree -= str.size();
+  return stored;
+}
+
+bool FileEntry::keyLess(const TreeItem::Key& lhs, const TreeItem::Key& rhs) const
+{
+  const auto globalId = [this](std::uint32_t formId) {
+    return (static_cast<std::uint64_t>(m_Files[formId >> 24U]) << 24U) |
+           (formId & 0xFFFFFFU);
+  };
+
+  if (const auto formId = std::get_if<std::uint32_t>(&lhs)) {
+    if (const auto other = std::get_if<std::uint32_t>(&rhs)) {
+      return globalId(*formId) < globalId(*other);
+    }
+  } else if (const auto group = std::get_if<TESFile::GroupData>(&lhs)) {
+    const auto other = std::get_if<TESFile::GroupData>(&rhs);
+    if (other && group->hasParent() && group->type() == other->type()) {
+      return globalId(group->parent()) < globalId(other->parent());
+    }
   }
 
-  return recordItem;
+  return lhs < rhs;
 }
 
 }  // namespace TESData
@@ -1,6 +1,8 @@
 #ifndef TESDATA_FILEENTRY_H
 #define TESDATA_FILEENTRY_H
 
+#include "FileNames.h"
+#include "FreezeState.h"
 #include "Record.h"
 #include "RecordPath.h"
 #include "TESFile/Type.h"
@@ -8,11 +10,16 @@
 #include <boost/container/flat_map.hpp>
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <shared_mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -26,46 +33,155 @@ using TESFileHandle = int;
 class FileEntry final
 {
 public:
+  using ItemIndex                   = std::uint32_t;
+  static constexpr ItemIndex NoItem = 0xFFFFFFFF;
+
+  // Node of the record tree. Nodes are pooled per entry and refer to each other by
+  // index. Their strings are stored by the entry, and their children are a range of
+  // the entry's child list, sorted by key once the entry is finalized.
   struct TreeItem
   {
-    using Key =
-        std::variant<TESFile::GroupData, std::uint32_t, std::string, TESFile::Type>;
-
-    const TreeItem* parent{nullptr};
-    std::string name;
+    using Key = std::variant<TESFile::GroupData, std::uint32_t, std::string_view,
+                             TESFile::Type>;
+
+    ItemIndex index{0};
+    ItemIndex parent{NoItem};
+    std::uint32_t row{0};
+    Key key;
+    std::string_view name;
     TESFile::Type formType{};
     std::optional<TESFile::GroupData> group;
-    std::shared_ptr<Record> record;
-    cont::flat_map<Key, std::shared_ptr<TreeItem>> children;
+    Record* record{nullptr};
+
+    // children as of the last time the entry was finalized
+    std::uint32_t firstChild{0};
+    std::uint32_t childCount{0};
+
+    // the child added last, to tell whether children arrive in order
+    ItemIndex lastChild{NoItem};
+
+    // whether the name was given by the plugin that owns the record
+    bool ownName{false};
   };
 
   FileEntry(TESFileHandle handle, const std::string& name);
 
   [[nodiscard]] TESFileHandle handle() const { return m_Handle; }
   [[nodiscard]] const std::string& name() const { return m_Name; }
-  [[nodiscard]] TreeItem* dataRoot() const { return m_Root.get(); }
-  [[nodiscard]] const std::vector<std::string>& files() const { return m_Files; }
+  [[nodiscard]] TreeItem* dataRoot() { return &m_Items.front(); }
+  [[nodiscard]] const std::vector<FileId>& files() const { return m_Files; }
+
+  [[nodiscard]] TreeItem* item(ItemIndex index) { return &m_Items[index]; }
+  [[nodiscard]] const TreeItem* item(ItemIndex index) const { return &m_Items[index]; }
+
+  [[nodiscard]] std::span<const ItemIndex> children(const TreeItem& item) const
+  {
+    return {m_ChildList.data() + item.firstChild, item.childCount};
+  }
+
+  void forEachRecord(std::function<void(const Record&)> func) const;
 
-  void
-  forEachRecord(std::function<void(const std::shared_ptr<const Record>&)> func) const;
+  // Returns the record at the path, creating it if needed. When several plugins name
+  // the record differently, the owning plugin's name wins, then the lowest one, so
+  // that the result does not depend on the order plugins are scanned in. The record
+  // is owned by this entry.
+  Record* createRecord(const RecordPath& path, const std::string& name,
+                       TESFile::Type formType, bool fromOwner);
 
-  std::shared_ptr<Record> createRecord(const RecordPath& path, const std::string& name,
-                                       TESFile::Type formType);
+  // Adds a record owned by another entry
   void addRecord(const RecordPath& path, const std::string& name,
-                 TESFile::Type formType, std::shared_ptr<Record> record);
+                 TESFile::Type formType, Record* record);
   void addChildGroup(const RecordPath&);
 
-  [[nodiscard]] std::shared_ptr<Record> findRecord(const RecordPath& path) const;
-  [[nodiscard]] std::shared_ptr<TreeItem> findItem(const RecordPath& path) const;
+  // Adds the items created since the last call to the child list, sorts the children
+  // of items that gained children out of order, and renumbers their rows
+  void finalize();
+
+  // See FreezeState. Records of lazily loaded branches are still added to a frozen
+  // entry, from the thread that froze it.
+  void freeze() { m_Freeze.freeze(); }
+  void thaw() { m_Freeze.thaw(); }
+
+  [[nodiscard]] Record* findRecord(const RecordPath& path) const;
+  [[nodiscard]] const TreeItem* findItem(const RecordPath& path) const;
 
 private:
-  std::shared_ptr<TreeItem> createHierarchy(const RecordPath& path);
+  // These expect the caller to hold the mutex
+  [[nodiscard]] ItemIndex findIndex(const RecordPath& path) const;
+  [[nodiscard]] ItemIndex findChild(ItemIndex parent, const TreeItem::Key& key) const;
+
+  ItemIndex createHierarchy(const RecordPath& path);
+
+  // Gives the item a new record identified by its key
+  Record* createRecord(TreeItem& item);
+
+  // Copies the string into storage that lives as long as the entry
+  std::string_view storeString(std::string_view str);
+
+  // Returns the child with the given key, and whether it had to be created
+  std::pair<TreeItem&, bool> getOrCreateChild(ItemIndex parent, TreeItem::Key key);
+
+  // Orders keys by the files that own their form IDs, rather than by the local file
+  // indices, which are numbered in the order records happen to be added
+  [[nodiscard]] bool keyLess(const TreeItem::Key& lhs, const TreeItem::Key& rhs) const;
 
   TESFileHandle m_Handle;
   std::string m_Name;
-  std::shared_ptr<TreeItem> m_Root;
-  std::vector<std::string> m_Files;
+
+  // Identifies an item by its parent and key, for heterogeneous lookup
+  struct ChildKey
+  {
+    ItemIndex parent;
+    const TreeItem::Key& key;
+  };
+
+  struct ChildHash
+  {
+    using is_transparent = void;
+
+    const std::deque<TreeItem>* items;
+
+    std::size_t operator()(ItemIndex index) const;
+    std::size_t operator()(const ChildKey& key) const;
+  };
+
+  struct ChildEqual
+  {
+    using is_transparent = void;
+
+    const std::deque<TreeItem>* items;
+
+    bool operator()(ItemIndex lhs, ItemIndex rhs) const { return lhs == rhs; }
+    bool operator()(const ChildKey& lhs, ItemIndex rhs) const;
+    bool operator()(ItemIndex lhs, const ChildKey& rhs) const
+    {
+      return (*this)(rhs, lhs);
+    }
+  };
+
+  // deques, so that items and records do not move when more are added
+  std::deque<TreeItem> m_Items;
+  std::deque<Record> m_Records;
+
+  // every item except the root, looked up by parent and key
+  std::unordered_set<ItemIndex, ChildHash, ChildEqual> m_Children;
+
+  // children of every item, each item's in one contiguous range
+  std::vector<ItemIndex> m_ChildList;
+
+  // number of items already in the child list
+  std::size_t m_FinalizedItems = 1;
+
+  // items whose children are out of order, possibly repeated
+  std::vector<ItemIndex> m_Unsorted;
+
+  // blocks of string storage, the last one filled from the cursor
+  std::vector<std::unique_ptr<char[]>> m_StringBlocks;
+  char* m_StringCursor          = nullptr;
+  std::size_t m_StringBlockFree = 0;
+  std::vector<FileId> m_Files;
   mutable std::shared_mutex m_Mutex;
+  FreezeState m_Freeze;
 };
 
 }  // namespace TESData
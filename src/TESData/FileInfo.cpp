@@ -4,6 +4,7 @@
 #include "PluginList.h"
 
 #include <algorithm>
+#include <utility>
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -21,10 +22,7 @@ FileInfo::FileInfo(PluginList* pluginList, const QString& name, bool forceLoaded
           .forceLoaded   = forceLoaded,
           .forceEnabled  = forceEnabled,
           .forceDisabled = forceDisabled,
-      },
-      m_Conflicts{[this]() {
-        return doConflictCheck();
-      }}
+      }
 {}
 
 bool FileInfo::isMasterFile() const
@@ -49,113 +47,116 @@ bool FileInfo::canBeToggled() const
          !m_FileSystemData.forceDisabled;
 }
 
-bool FileInfo::mustLoadAfter(const FileInfo& other) const
-{
-  const bool hasMaster = this->masters().contains(other.name(), Qt::CaseInsensitive);
-  const bool isMaster  = other.masters().contains(this->name(), Qt::CaseInsensitive);
-
-  if (hasMaster && !isMaster) {
-    return true;
-  } else if (isMaster) {
-    return false;
-  }
-
-  if (other.forceLoaded() && !this->forceLoaded()) {
-    return true;
-  }
-
-  if (other.isMasterFile() && !this->isMasterFile()) {
-    return true;
-  }
-
-  return false;
-}
-
 static void checkConflict(QSet<int>& winning, QSet<int>& losing, const FileInfo& file,
                           const TESData::PluginList* pluginList,
                           TESFileHandle alternative, bool ignoreMasters)
 {
-  const auto entry      = pluginList->findEntryByName(file.name().toStdString());
-  const auto otherEntry = pluginList->findEntryByHandle(alternative);
-  if (otherEntry == nullptr || otherEntry == entry) {
+  if (alternative == file.handle()) {
     return;
   }
 
-  const auto otherFile =
-      pluginList->getPluginByName(QString::fromStdString(otherEntry->name()));
-  if (otherFile == nullptr) {
+  const int otherIndex = pluginList->getIndexByHandle(alternative);
+  if (otherIndex == -1) {
     return;
   }
 
-  const QString otherName = QString::fromStdString(otherEntry->name());
-  const int otherIndex    = pluginList->getIndex(otherName);
+  const auto otherFile = pluginList->getPlugin(otherIndex);
 
   if (file.priority() > otherFile->priority()) {
-    if (!ignoreMasters ||
-        !file.masters().contains(otherFile->name(), Qt::CaseInsensitive)) {
+    if (!ignoreMasters || !file.hasMaster(alternative)) {
       winning.insert(otherIndex);
     }
   } else {
-    if (!ignoreMasters ||
-        !otherFile->masters().contains(file.name(), Qt::CaseInsensitive)) {
+    if (!ignoreMasters || !otherFile->hasMaster(file.handle())) {
       losing.insert(otherIndex);
     }
   }
 }
 
-FileInfo::Conflicts FileInfo::doConflictCheck() const
+static void updateConflictState(FileInfo::Conflicts& conflicts)
 {
-  Conflicts conflicts;
+  uint conflictState = FileInfo::CONFLICT_NONE;
+  if (!conflicts.m_OverridingList.empty()) {
+    conflictState |= FileInfo::CONFLICT_OVERRIDE;
+  }
+  if (!conflicts.m_OverriddenList.empty()) {
+    conflictState |= FileInfo::CONFLICT_OVERRIDDEN;
+  }
+  if (!conflicts.m_OverwritingArchiveList.empty()) {
+    conflictState |= FileInfo::CONFLICT_ARCHIVE_OVERWRITE;
+  }
+  if (!conflicts.m_OverwrittenArchiveList.empty()) {
+    conflictState |= FileInfo::CONFLICT_ARCHIVE_OVERWRITTEN;
+  }
+  conflicts.m_CurrentConflictState =
+      static_cast<FileInfo::EConflictFlag>(conflictState);
+}
 
-  const auto entry = m_PluginList->findEntryByName(name().toStdString());
-  if (entry == nullptr) {
-    return conflicts;
+const FileInfo::Conflicts& FileInfo::conflicts() const
+{
+  static const Conflicts none;
+  if (!m_Conflicts) {
+    const auto matrix = m_PluginList->conflictMatrix();
+    if (matrix == nullptr) {
+      return none;
+    }
+
+    const bool ignoreMasters =
+        Settings::instance()->get<bool>("ignore_master_conflicts", false);
+    m_Conflicts = checkConflicts(*matrix, ignoreMasters);
   }
 
-  const bool ignoreMasters =
-      Settings::instance()->get<bool>("ignore_master_conflicts", false);
+  return *m_Conflicts;
+}
 
-  entry->forEachRecord([&](auto&& record) {
-    if (record->ignored())
-      return;
+FileInfo::Conflicts FileInfo::checkConflicts(const ConflictMatrix& matrix,
+                                             bool ignoreMasters) const
+{
+  Conflicts conflicts;
 
-    for (const auto alternative : record->alternatives()) {
+  for (const auto& [other, overlap] : matrix.row(m_Handle)) {
+    if (overlap.records != 0) {
       checkConflict(conflicts.m_OverridingList, conflicts.m_OverriddenList, *this,
-                    m_PluginList, alternative, ignoreMasters);
+                    m_PluginList, other, ignoreMasters);
     }
-  });
 
-  for (const auto& archive : m_FileSystemData.archives) {
-    const auto archiveEntry = m_PluginList->findArchive(archive);
-    if (!archiveEntry) {
-      continue;
+    if (overlap.archiveFiles != 0) {
+      checkConflict(conflicts.m_OverwritingArchiveList,
+                    conflicts.m_OverwrittenArchiveList, *this, m_PluginList, other,
+                    ignoreMasters);
     }
-
-    archiveEntry->forEachMember([&](auto&& item) {
-      for (const auto alternative : item->alternatives) {
-        checkConflict(conflicts.m_OverwritingArchiveList,
-                      conflicts.m_OverwrittenArchiveList, *this, m_PluginList,
-                      alternative, ignoreMasters);
-      }
-    });
   }
 
-  uint conflictState = CONFLICT_NONE;
-  if (!conflicts.m_OverridingList.empty()) {
-    conflictState |= CONFLICT_OVERRIDE;
-  }
-  if (!conflicts.m_OverriddenList.empty()) {
-    conflictState |= CONFLICT_OVERRIDDEN;
+  updateConflictState(conflicts);
+  return conflicts;
+}
+
+void FileInfo::updateConflict(const FileInfo& other, ConflictMatrix::Overlap overlap,
+                              bool ignoreMasters) const
+{
+  if (!m_Conflicts) {
+    return;
   }
-  if (!conflicts.m_OverwritingArchiveList.empty()) {
-    conflictState |= CONFLICT_ARCHIVE_OVERWRITE;
+
+  auto& conflicts      = *m_Conflicts;
+  const int otherIndex = m_PluginList->getIndexByHandle(other.handle());
+  conflicts.m_OverridingList.remove(otherIndex);
+  conflicts.m_OverriddenList.remove(otherIndex);
+  conflicts.m_OverwritingArchiveList.remove(otherIndex);
+  conflicts.m_OverwrittenArchiveList.remove(otherIndex);
+
+  if (overlap.records != 0) {
+    checkConflict(conflicts.m_OverridingList, conflicts.m_OverriddenList, *this,
+                  m_PluginList, other.handle(), ignoreMasters);
   }
-  if (!conflicts.m_OverwrittenArchiveList.empty()) {
-    conflictState |= CONFLICT_ARCHIVE_OVERWRITTEN;
+
+  if (overlap.archiveFiles != 0) {
+    checkConflict(conflicts.m_OverwritingArchiveList,
+                  conflicts.m_OverwrittenArchiveList, *this, m_PluginList,
+                  other.handle(), ignoreMasters);
   }
-  conflicts.m_CurrentConflictState = static_cast<EConflictFlag>(conflictState);
 
-  return conflicts;
+  updateConflictState(conflicts);
 }
 
 }  // namespace TESData
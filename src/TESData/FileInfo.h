@@ -1,20 +1,26 @@
 #ifndef TESDATA_FILEINFO_H
 #define TESDATA_FILEINFO_H
 
+#include "ConflictMatrix.h"
+
 #include <ifiletree.h>
-#include <memoizedlock.h>
 
 #include <boost/container/flat_set.hpp>
+#include <boost/dynamic_bitset.hpp>
 
 #include <QDateTime>
 #include <QSet>
 #include <QString>
 
+#include <optional>
+
 namespace TESData
 {
 
 class PluginList;
 
+using TESFileHandle = int;
+
 class FileInfo
 {
 public:
@@ -132,6 +138,23 @@ public:
   [[nodiscard]] const auto& masters() const { return m_Metadata.masters; }
   void addMaster(const QString& master) { m_Metadata.masters.push_back(master); }
 
+  // Handle of the plugin's record entry, or -1 if it has none
+  [[nodiscard]] TESFileHandle handle() const { return m_Handle; }
+
+  [[nodiscard]] bool hasMaster(TESFileHandle handle) const
+  {
+    return handle >= 0 && static_cast<std::size_t>(handle) < m_MasterHandles.size() &&
+           m_MasterHandles.test(handle);
+  }
+
+  // Sets the entry handles of the plugin and of its masters, see
+  // PluginList::updateCache
+  void setHandles(TESFileHandle handle, boost::dynamic_bitset<> masters)
+  {
+    m_Handle        = handle;
+    m_MasterHandles = std::move(masters);
+  }
+
   [[nodiscard]] bool hasMissingMasters() const
   {
     return !m_Metadata.masterUnset.empty();
@@ -149,11 +172,7 @@ public:
   [[nodiscard]] bool enabled() const { return m_State.enabled; }
   void setEnabled(bool enabled) { m_State.enabled = enabled; }
   [[nodiscard]] int priority() const { return m_State.priority; }
-  void setPriority(int priority)
-  {
-    m_State.priority = priority;
-    m_Conflicts.invalidate();
-  }
+  void setPriority(int priority) { m_State.priority = priority; }
   [[nodiscard]] const QString& index() const { return m_State.index; }
   void setIndex(const QString& index) { m_State.index = index; }
   [[nodiscard]] int loadOrder() const { return m_State.loadOrder; }
@@ -163,45 +182,55 @@ public:
 
   [[nodiscard]] EConflictFlag conflictState() const
   {
-    return m_Conflicts.value().m_CurrentConflictState;
+    return conflicts().m_CurrentConflictState;
   }
 
   [[nodiscard]] const auto& getPluginOverriding() const
   {
-    return m_Conflicts.value().m_OverridingList;
+    return conflicts().m_OverridingList;
   }
 
   [[nodiscard]] const auto& getPluginOverridden() const
   {
-    return m_Conflicts.value().m_OverriddenList;
+    return conflicts().m_OverriddenList;
   }
 
   [[nodiscard]] const auto& getPluginOverwritingArchive() const
   {
-    return m_Conflicts.value().m_OverwritingArchiveList;
+    return conflicts().m_OverwritingArchiveList;
   }
 
   [[nodiscard]] const auto& getPluginOverwrittenArchive() const
   {
-    return m_Conflicts.value().m_OverwrittenArchiveList;
+    return conflicts().m_OverwrittenArchiveList;
   }
 
   [[nodiscard]] bool isMasterFile() const;
   [[nodiscard]] bool isSmallFile() const;
   [[nodiscard]] bool isAlwaysEnabled() const;
   [[nodiscard]] bool canBeToggled() const;
-  [[nodiscard]] bool mustLoadAfter(const FileInfo& other) const;
 
-  void invalidateConflicts() const { m_Conflicts.invalidate(); }
+  void invalidateConflicts() const { m_Conflicts.reset(); }
+
+  // Reclassifies `other` in the cached conflicts after either plugin changed
+  // priority, leaving the conflicts with every other plugin as they are
+  void updateConflict(const FileInfo& other, ConflictMatrix::Overlap overlap,
+                      bool ignoreMasters) const;
 
 private:
-  [[nodiscard]] Conflicts doConflictCheck() const;
+  // Conflicts are derived from the plugin list's conflict matrix when first read
+  // after being invalidated, and are empty while the matrix is being built
+  [[nodiscard]] const Conflicts& conflicts() const;
+  [[nodiscard]] Conflicts checkConflicts(const ConflictMatrix& matrix,
+                                         bool ignoreMasters) const;
 
   PluginList* m_PluginList;
   FileSystemData m_FileSystemData;
   Metadata m_Metadata;
   State m_State;
-  mutable MOBase::MemoizedLocked<Conflicts> m_Conflicts;
+  TESFileHandle m_Handle = -1;
+  boost::dynamic_bitset<> m_MasterHandles;
+  mutable std::optional<Conflicts> m_Conflicts;
 };
 
 }  // namespace TESData
@@ -0,0 +1,80 @@
+#include "FileNames.h"
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace TESData
+{
+
+namespace
+{
+
+struct Table
+{
+  Table()
+  {
+    names.emplace_back();
+    ids.emplace(std::string(), FileNames::None);
+  }
+
+  std::shared_mutex mutex;
+
+  // IDs keyed by lowercase name
+  std::unordered_map<std::string, FileId> ids;
+
+  // a deque, so that names do not move when more are added
+  std::deque<std::string> names;
+};
+
+Table& table()
+{
+  static Table instance;
+  return instance;
+}
+
+}  // namespace
+
+FileId FileNames::intern(std::string_view name)
+{
+  std::string key{name};
+  std::ranges::transform(key, key.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+
+  auto& t = table();
+  {
+    std::shared_lock lk{t.mutex};
+    if (const auto it = t.ids.find(key); it != t.ids.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock lk{t.mutex};
+  if (const auto it = t.ids.find(key); it != t.ids.end()) {
+    return it->second;
+  }
+
+  if (t.names.size() > std::numeric_limits<FileId>::max()) {
+    throw std::length_error("too many file names");
+  }
+
+  const auto id = static_cast<FileId>(t.names.size());
+  t.names.emplace_back(name);
+  t.ids.emplace(std::move(key), id);
+  return id;
+}
+
+const std::string& FileNames::name(FileId id)
+{
+  auto& t = table();
+  std::shared_lock lk{t.mutex};
+  return t.names[id];
+}
+
+}  // namespace TESData
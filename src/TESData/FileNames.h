@@ -0,0 +1,30 @@
+#ifndef TESDATA_FILENAMES_H
+#define TESDATA_FILENAMES_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace TESData
+{
+
+using FileId = std::uint16_t;
+
+// Process-wide table of plugin file names. Each name is given a small ID, so that
+// paths and records can store and compare names as integers. Names that differ only
+// in case share an ID, and keep the spelling they were first interned with.
+class FileNames final
+{
+public:
+  // ID of the empty name, used where a record has no owning file
+  static constexpr FileId None = 0;
+
+  // Returns the ID of the name, adding it to the table if needed
+  static FileId intern(std::string_view name);
+
+  [[nodiscard]] static const std::string& name(FileId id);
+};
+
+}  // namespace TESData
+
+#endif  // TESDATA_FILENAMES_H
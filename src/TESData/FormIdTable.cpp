@@ -0,0 +1,111 @@
+#include "FormIdTable.h"
+
+#include <mutex>
+
+namespace TESData
+{
+
+static constexpr std::size_t InitialCapacity = 64;
+
+void FormIdTable::clear()
+{
+  for (auto& shard : m_Shards) {
+    std::unique_lock lk{shard.mutex};
+    shard.slots.clear();
+    shard.size = 0;
+  }
+}
+
+Record* FormIdTable::insert(FileId file, std::uint32_t objectId, Record* record)
+{
+  const auto key = makeKey(file, objectId);
+  const auto h   = hash(key);
+  auto& shard    = m_Shards[h >> (64 - ShardBits)];
+
+  {
+    std::shared_lock lk{shard.mutex};
+    if (!shard.slots.empty()) {
+      const auto& slot = shard.slots[probe(shard, key, h)];
+      if (slot.key == key) {
+        return slot.record;
+      }
+    }
+  }
+
+  std::unique_lock lk{shard.mutex};
+
+  // keep the load factor below 3/4
+  if ((shard.size + 1) * 4 > shard.slots.size() * 3) {
+    grow(shard);
+  }
+
+  auto& slot = shard.slots[probe(shard, key, h)];
+  if (slot.key != key) {
+    slot = {key, record};
+    ++shard.size;
+  }
+  return slot.record;
+}
+
+Record* FormIdTable::find(FileId file, std::uint32_t objectId) const
+{
+  const auto key    = makeKey(file, objectId);
+  const auto h      = hash(key);
+  const auto& shard = m_Shards[h >> (64 - ShardBits)];
+
+  std::shared_lock lk{shard.mutex};
+  if (shard.slots.empty()) {
+    return nullptr;
+  }
+
+  const auto& slot = shard.slots[probe(shard, key, h)];
+  return slot.key == key ? slot.record : nullptr;
+}
+
+std::uint64_t FormIdTable::makeKey(FileId file, std::uint32_t objectId)
+{
+  // the top bit marks the slot as used
+  return (std::uint64_t{1} << 63) | (std::uint64_t{file} << 24) |
+         (objectId & 0xFFFFFF);
+}
+
+std::uint64_t FormIdTable::hash(std::uint64_t key)
+{
+  // finalizer of splitmix64
+  key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+  return key ^ (key >> 31);
+}
+
+std::size_t FormIdTable::probe(const Shard& shard, std::uint64_t key, std::uint64_t hash)
+{
+  const std::size_t mask = shard.slots.size() - 1;
+  for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+    const auto& slot = shard.slots[i];
+    if (slot.key == key || slot.key == 0) {
+      return i;
+    }
+  }
+}
+
+void FormIdTable::grow(Shard& shard)
+{
+  std::vector<Slot> slots(shard.slots.empty() ? InitialCapacity
+                                              : shard.slots.size() * 2);
+  std::swap(slots, shard.slots);
+
+  const std::size_t mask = shard.slots.size() - 1;
+  for (const auto& slot : slots) {
+    if (slot.key == 0) {
+      continue;
+    }
+
+    std::size_t i = hash(slot.key) & mask;
+    while (shard.slots[i].key != 0) {
+      i = (i + 1) & mask;
+    }
+    shard.slots[i] = slot;
+  }
+}
+
+}  // namespace TESData
@@ -0,0 +1,61 @@
+#ifndef TESDATA_FORMIDTABLE_H
+#define TESDATA_FORMIDTABLE_H
+
+#include "FileNames.h"
+#include "Record.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <vector>
+
+namespace TESData
+{
+
+// Maps the owning file and object ID of a form to its record, so that a record can be
+// found without walking a file's record tree. The table uses open addressing, and is
+// split into shards that are locked separately so that several plugins can be scanned
+// into it at once.
+class FormIdTable final
+{
+public:
+  void clear();
+
+  // Adds the record if there is none for the form yet, and returns the stored record
+  Record* insert(FileId file, std::uint32_t objectId, Record* record);
+
+  [[nodiscard]] Record* find(FileId file, std::uint32_t objectId) const;
+
+private:
+  static constexpr std::size_t ShardBits = 6;
+
+  struct Slot
+  {
+    // zero for an empty slot
+    std::uint64_t key;
+    Record* record;
+  };
+
+  struct Shard
+  {
+    mutable std::shared_mutex mutex;
+    std::vector<Slot> slots;
+    std::size_t size = 0;
+  };
+
+  [[nodiscard]] static std::uint64_t makeKey(FileId file, std::uint32_t objectId);
+  [[nodiscard]] static std::uint64_t hash(std::uint64_t key);
+
+  // Returns the index of the slot holding the key, or of the empty slot where it
+  // would go. The shard must not be empty.
+  [[nodiscard]] static std::size_t probe(const Shard& shard, std::uint64_t key,
+                                         std::uint64_t hash);
+  static void grow(Shard& shard);
+
+  std::array<Shard, std::size_t{1} << ShardBits> m_Shards;
+};
+
+}  // namespace TESData
+
+#endif  // TESDATA_FORMIDTABLE_H
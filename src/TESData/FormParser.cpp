@@ -54,10 +54,9 @@ QString readLstring(bool localized, std::istream& stream)
   }
 }
 
-QString readFormId(std::span<const std::string> masters,
-                          const std::string& plugin, std::istream& stream)
+static QString formIdString(std::span<const std::string> masters,
+                            const std::string& plugin, std::uint32_t formId)
 {
-  const std::uint32_t formId = TESFile::readType<std::uint32_t>(stream);
   if (!formId) {
     return u"NONE"_s;
   }
@@ -69,6 +68,33 @@ QString readFormId(std::span<const std::string> masters,
       .arg(QString::fromStdString(file));
 }
 
+QString readFormId(std::span<const std::string> masters,
+                          const std::string& plugin, std::istream& stream)
+{
+  const std::uint32_t formId = TESFile::readType<std::uint32_t>(stream);
+  return formIdString(masters, plugin, formId);
+}
+
+QString readLstring(bool localized, TESFile::Cursor& data)
+{
+  if (localized) {
+    const std::uint32_t index = TESFile::readType<std::uint32_t>(data);
+    if (index == 0) {
+      return u""_s;
+    }
+    return u"<lstring:%1>"_s.arg(index);
+  } else {
+    const std::string_view str = TESFile::readZstring(data);
+    return QString::fromUtf8(str);
+  }
+}
+
+QString readFormId(std::span<const std::string> masters, const std::string& plugin,
+                   TESFile::Cursor& data)
+{
+  return formIdString(masters, plugin, TESFile::readFormId(data));
+}
+
 static void parseUnknown(DataItem* parent, int& index, int fileIndex,
                          TESFile::Type signature, std::istream& stream)
 {
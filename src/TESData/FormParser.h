@@ -2,6 +2,7 @@
 #define TESDATA_FORMPARSER_H
 
 #include "DataItem.h"
+#include "TESFile/Cursor.h"
 #include "TESFile/Stream.h"
 #include "TESFile/Type.h"
 
@@ -110,6 +111,10 @@ QString readLstring(bool localized, std::istream& stream);
 QString readFormId(std::span<const std::string> masters, const std::string& plugin,
                    std::istream& stream);
 
+QString readLstring(bool localized, TESFile::Cursor& data);
+QString readFormId(std::span<const std::string> masters, const std::string& plugin,
+                   TESFile::Cursor& data);
+
 }  // namespace TESData
 
 #endif  // TESDATA_FORMPARSER_H
@@ -0,0 +1,48 @@
+#ifndef TESDATA_FREEZESTATE_H
+#define TESDATA_FREEZESTATE_H
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace TESData
+{
+
+// Tracks whether a structure that is built by several threads has been completed.
+// Once frozen, the structure is only changed from the thread that froze it, which
+// can therefore read it without taking its lock. Other threads keep locking, so that
+// they see those changes safely.
+class FreezeState final
+{
+public:
+  void freeze()
+  {
+    m_Owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    m_Frozen.store(true, std::memory_order_release);
+  }
+
+  void thaw() { m_Frozen.store(false, std::memory_order_release); }
+
+  [[nodiscard]] bool frozen() const { return m_Frozen.load(std::memory_order_acquire); }
+
+  // Returns a shared lock on `mutex`, left unlocked when the caller needs none
+  [[nodiscard]] std::shared_lock<std::shared_mutex>
+  readLock(std::shared_mutex& mutex) const
+  {
+    if (frozen() &&
+        m_Owner.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+      return std::shared_lock{mutex, std::defer_lock};
+    } else {
+      return std::shared_lock{mutex};
+    }
+  }
+
+private:
+  std::atomic<bool> m_Frozen{false};
+  std::atomic<std::thread::id> m_Owner;
+};
+
+}  // namespace TESData
+
+#endif  // TESDATA_FREEZESTATE_H
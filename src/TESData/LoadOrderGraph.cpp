@@ -0,0 +1,257 @@
+#include "LoadOrderGraph.h"
+
+#include <log.h>
+
+#include <QStringList>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace TESData
+{
+
+static LoadOrderGraph::Partition partitionOf(const FileInfo& plugin)
+{
+  if (plugin.forceLoaded()) {
+    return LoadOrderGraph::Partition_ForceLoaded;
+  } else if (plugin.isMasterFile()) {
+    return LoadOrderGraph::Partition_Master;
+  } else {
+    return LoadOrderGraph::Partition_Regular;
+  }
+}
+
+// Returns the plugin of `indices` with the highest or the lowest priority, or -1
+template <typename Compare>
+static int boundOf(std::span<const int> indices,
+                   std::span<const std::shared_ptr<FileInfo>> plugins, Compare compare)
+{
+  int bound = -1;
+  for (const int index : indices) {
+    if (bound == -1 ||
+        compare(plugins[index]->priority(), plugins[bound]->priority())) {
+      bound = index;
+    }
+  }
+  return bound;
+}
+
+LoadOrderGraph::LoadOrderGraph(std::span<const std::shared_ptr<FileInfo>> plugins,
+                               const std::function<int(const QString&)>& indexOf)
+    : m_Partitions(plugins.size()), m_Masters(plugins.size()),
+      m_Dependents(plugins.size()), m_LastMasters(plugins.size(), -1),
+      m_FirstDependents(plugins.size(), -1)
+{
+  for (int i = 0; i < plugins.size(); ++i) {
+    m_Partitions[i] = partitionOf(*plugins[i]);
+
+    for (const auto& master : plugins[i]->masters()) {
+      const int masterIndex = indexOf(master);
+      if (masterIndex != -1 && masterIndex != i) {
+        m_Masters[i].push_back(masterIndex);
+      }
+    }
+
+    std::ranges::sort(m_Masters[i]);
+    const auto duplicates = std::ranges::unique(m_Masters[i]);
+    m_Masters[i].erase(duplicates.begin(), duplicates.end());
+  }
+
+  // plugins that are each other's masters can load in either order
+  std::vector<std::vector<int>> masters(plugins.size());
+  for (int i = 0; i < plugins.size(); ++i) {
+    std::ranges::copy_if(m_Masters[i], std::back_inserter(masters[i]), [&](int j) {
+      return !std::ranges::binary_search(m_Masters[j], i);
+    });
+  }
+  m_Masters = std::move(masters);
+
+  for (int i = 0; i < plugins.size(); ++i) {
+    for (const int master : m_Masters[i]) {
+      m_Dependents[master].push_back(i);
+    }
+  }
+
+  // a master joins the earliest partition of the plugins that require it
+  std::deque<int> queue(plugins.size());
+  std::iota(queue.begin(), queue.end(), 0);
+  while (!queue.empty()) {
+    const int index = queue.front();
+    queue.pop_front();
+
+    for (const int master : m_Masters[index]) {
+      if (m_Partitions[master] > m_Partitions[index]) {
+        m_Partitions[master] = m_Partitions[index];
+        queue.push_back(master);
+      }
+    }
+  }
+
+  for (const Partition partition : m_Partitions) {
+    ++m_PartitionStarts[partition + 1];
+  }
+  for (int i = 1; i < m_PartitionStarts.size(); ++i) {
+    m_PartitionStarts[i] += m_PartitionStarts[i - 1];
+  }
+
+  updateBounds(plugins);
+}
+
+bool LoadOrderGraph::mustLoadAfter(int index, int other) const
+{
+  if (std::ranges::binary_search(m_Masters[index], other)) {
+    return true;
+  } else if (std::ranges::binary_search(m_Masters[other], index)) {
+    return false;
+  }
+
+  return m_Partitions[other] < m_Partitions[index];
+}
+
+void LoadOrderGraph::updateBounds(std::span<const std::shared_ptr<FileInfo>> plugins)
+{
+  for (int i = 0; i < size(); ++i) {
+    m_LastMasters[i]     = boundOf(m_Masters[i], plugins, std::greater<>());
+    m_FirstDependents[i] = boundOf(m_Dependents[i], plugins, std::less<>());
+  }
+}
+
+void LoadOrderGraph::updateBounds(int index,
+                                  std::span<const std::shared_ptr<FileInfo>> plugins)
+{
+  const int priority = plugins[index]->priority();
+
+  for (const int dependent : m_Dependents[index]) {
+    int& bound = m_LastMasters[dependent];
+    if (bound == index) {
+      bound = boundOf(m_Masters[dependent], plugins, std::greater<>());
+    } else if (bound == -1 || priority > plugins[bound]->priority()) {
+      bound = index;
+    }
+  }
+
+  for (const int master : m_Masters[index]) {
+    int& bound = m_FirstDependents[master];
+    if (bound == index) {
+      bound = boundOf(m_Dependents[master], plugins, std::less<>());
+    } else if (bound == -1 || priority < plugins[bound]->priority()) {
+      bound = index;
+    }
+  }
+}
+
+std::pair<int, int>
+LoadOrderGraph::destinations(int index,
+                             std::span<const std::shared_ptr<FileInfo>> plugins) const
+{
+  int first = m_PartitionStarts[m_Partitions[index]];
+  int last  = m_PartitionStarts[m_Partitions[index] + 1];
+
+  if (const int master = m_LastMasters[index]; master != -1) {
+    first = std::max(first, plugins[master]->priority() + 1);
+  }
+
+  if (const int dependent = m_FirstDependents[index]; dependent != -1) {
+    last = std::min(last, plugins[dependent]->priority());
+  }
+
+  return {first, last};
+}
+
+std::vector<int>
+LoadOrderGraph::sort(std::span<const int> order,
+                     std::span<const std::shared_ptr<FileInfo>> plugins) const
+{
+  std::vector<int> positions(size(), -1);
+  std::size_t count = 0;
+  for (int i = 0; i < order.size(); ++i) {
+    if (positions[order[i]] == -1) {
+      ++count;
+    }
+    positions[order[i]] = i;
+  }
+
+  // number of masters in `order` that have not been placed yet
+  std::vector<int> pending(size(), 0);
+  for (const int index : order) {
+    const auto inOrder = std::ranges::count_if(m_Masters[index], [&](int master) {
+      return positions[master] != -1;
+    });
+    pending[index] = static_cast<int>(inOrder);
+  }
+
+  // plugins whose masters are all placed, by partition and then by position
+  using Key = std::pair<Partition, int>;
+  const auto keyOf = [&](int index) {
+    return Key{m_Partitions[index], positions[index]};
+  };
+
+  std::priority_queue<Key, std::vector<Key>, std::greater<>> ready;
+  for (const int index : order) {
+    if (pending[index] == 0) {
+      ready.push(keyOf(index));
+    }
+  }
+
+  std::vector<bool> placed(size(), false);
+  std::vector<int> sorted;
+  sorted.reserve(count);
+  while (sorted.size() < count) {
+    if (ready.empty()) {
+      // every plugin left waits for another, so their masters form a cycle
+      int first = -1;
+      for (const int index : order) {
+        if (!placed[index] && (first == -1 || keyOf(index) < keyOf(first))) {
+          first = index;
+        }
+      }
+
+      std::vector<int> path;
+      std::vector<bool> visited(size(), false);
+      int current = first;
+      while (!visited[current]) {
+        visited[current] = true;
+        path.push_back(current);
+        current = *std::ranges::find_if(m_Masters[current], [&](int master) {
+          return positions[master] != -1 && !placed[master];
+        });
+      }
+
+      QStringList cycle;
+      for (auto it = std::ranges::find(path, current); it != path.end(); ++it) {
+        cycle.append(plugins[*it]->name());
+      }
+      cycle.append(plugins[current]->name());
+      MOBase::log::warn("Plugins require each other as masters: {}",
+                        cycle.join(u" -> "));
+
+      pending[first] = 0;
+      ready.push(keyOf(first));
+    }
+
+    const int index = order[ready.top().second];
+    ready.pop();
+    if (placed[index]) {
+      continue;
+    }
+
+    placed[index] = true;
+    sorted.push_back(index);
+
+    for (const int dependent : m_Dependents[index]) {
+      if (positions[dependent] != -1 && !placed[dependent] &&
+          --pending[dependent] == 0) {
+        ready.push(keyOf(dependent));
+      }
+    }
+  }
+
+  return sorted;
+}
+
+}  // namespace TESData
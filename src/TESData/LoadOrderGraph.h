@@ -0,0 +1,96 @@
+#ifndef TESDATA_LOADORDERGRAPH_H
+#define TESDATA_LOADORDERGRAPH_H
+
+#include "FileInfo.h"
+
+#include <QString>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace TESData
+{
+
+// Constraints on the load order: plugins load after their masters, and force-loaded
+// plugins load before master files, which load before the rest. A plugin that is the
+// master of a plugin in an earlier partition is moved into that partition.
+class LoadOrderGraph final
+{
+public:
+  enum Partition : std::uint8_t
+  {
+    Partition_ForceLoaded,
+    Partition_Master,
+    Partition_Regular,
+    Partition_Count,
+  };
+
+  LoadOrderGraph() = default;
+
+  // Builds the graph over the indices of `plugins`. `indexOf` finds the index of a
+  // plugin by name, or returns -1 if it is not loaded.
+  LoadOrderGraph(std::span<const std::shared_ptr<FileInfo>> plugins,
+                 const std::function<int(const QString&)>& indexOf);
+
+  [[nodiscard]] std::size_t size() const { return m_Partitions.size(); }
+
+  [[nodiscard]] Partition partition(int index) const { return m_Partitions[index]; }
+
+  // Plugins that must load before or after the plugin at `index`. Plugins that are
+  // each other's masters are not constrained.
+  [[nodiscard]] std::span<const int> masters(int index) const
+  {
+    return m_Masters[index];
+  }
+
+  [[nodiscard]] std::span<const int> dependents(int index) const
+  {
+    return m_Dependents[index];
+  }
+
+  // Returns whether the plugin at `index` must load after the one at `other`
+  [[nodiscard]] bool mustLoadAfter(int index, int other) const;
+
+  // Finds the master with the highest priority and the dependent with the lowest
+  // priority of every plugin
+  void updateBounds(std::span<const std::shared_ptr<FileInfo>> plugins);
+
+  // Updates the bounds of the masters and dependents of the plugin at `index` after
+  // it changed priority
+  void updateBounds(int index, std::span<const std::shared_ptr<FileInfo>> plugins);
+
+  // Returns the first and last destination, as the priority of the plugin to insert
+  // before, that the plugin at `index` can be moved to without loading before one of
+  // its masters, after one of its dependents, or outside of its partition. The load
+  // order must already satisfy the constraints.
+  [[nodiscard]] std::pair<int, int>
+  destinations(int index, std::span<const std::shared_ptr<FileInfo>> plugins) const;
+
+  // Returns the plugin indices of `order` sorted so that every constraint holds,
+  // keeping their relative order wherever the constraints allow. Cycles of masters
+  // are logged and broken at the plugin that comes first in `order`.
+  [[nodiscard]] std::vector<int>
+  sort(std::span<const int> order,
+       std::span<const std::shared_ptr<FileInfo>> plugins) const;
+
+private:
+  std::vector<Partition> m_Partitions;
+  std::vector<std::vector<int>> m_Masters;
+  std::vector<std::vector<int>> m_Dependents;
+
+  // first priority of each partition, and the plugin count
+  std::array<int, Partition_Count + 1> m_PartitionStarts{};
+
+  // plugin indices of the bounds, or -1
+  std::vector<int> m_LastMasters;
+  std::vector<int> m_FirstDependents;
+};
+
+}  // namespace TESData
+
+#endif  // TESDATA_LOADORDERGRAPH_H
@@ -0,0 +1,32 @@
+#include "MasterListParser.h"
+
+#include <string_view>
+
+namespace TESData
+{
+
+TESFile::Traversal MasterListParser::Group([[maybe_unused]] TESFile::GroupData group)
+{
+  return TESFile::Traversal::Stop;
+}
+
+TESFile::Traversal MasterListParser::Form(TESFile::FormData form)
+{
+  return form.type() == "TES4"_ts ? TESFile::Traversal::Descend
+                                  : TESFile::Traversal::Stop;
+}
+
+bool MasterListParser::Chunk(TESFile::Type type)
+{
+  return type == "MAST"_ts;
+}
+
+void MasterListParser::Data(TESFile::Cursor& data)
+{
+  const std::string_view master = TESFile::readZstring(data);
+  if (!master.empty()) {
+    m_Masters.emplace_back(master);
+  }
+}
+
+}  // namespace TESData
@@ -0,0 +1,33 @@
+#ifndef TESDATA_MASTERLISTPARSER_H
+#define TESDATA_MASTERLISTPARSER_H
+
+#include "TESFile/Cursor.h"
+#include "TESFile/Reader.h"
+#include "TESFile/TypeSet.h"
+
+#include <string>
+#include <vector>
+
+namespace TESData
+{
+
+// Reads the master list from a plugin header and stops at the first group
+class MasterListParser final
+{
+public:
+  static constexpr TESFile::TypeSet WantedChunks{"MAST"_ts};
+
+  TESFile::Traversal Group(TESFile::GroupData group);
+  TESFile::Traversal Form(TESFile::FormData form);
+  bool Chunk(TESFile::Type type);
+  void Data(TESFile::Cursor& data);
+
+  [[nodiscard]] const std::vector<std::string>& masters() const { return m_Masters; }
+
+private:
+  std::vector<std::string> m_Masters;
+};
+
+}  // namespace TESData
+
+#endif  // TESDATA_MASTERLISTPARSER_H
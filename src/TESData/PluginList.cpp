@@ -1,5 +1,9 @@
 #include "PluginList.h"
 #include "FileConflictParser.h"
+#include "MOPlugin/Settings.h"
+#include "MasterListParser.h"
+#include "TESFile/HeaderScanner.h"
+#include "TESFile/MappedFile.h"
 #include "TESFile/Reader.h"
 
 #include <bsatk.h>
@@ -22,6 +26,7 @@
 #include <future>
 #include <iterator>
 #include <limits>
+#include <mutex>
 #include <ranges>
 #include <semaphore>
 #include <thread>
@@ -42,6 +47,7 @@ PluginList::PluginList(const MOBase::IOrganizer* moInfo) : m_Organizer{moInfo}
 
 PluginList::~PluginList() noexcept
 {
+  cancelConflicts();
   m_Refreshed.disconnect_all_slots();
   m_PluginMoved.disconnect_all_slots();
   m_PluginStateChanged.disconnect_all_slots();
@@ -66,6 +72,12 @@ int PluginList::getIndexAtPriority(int priority) const
   return m_PluginsByPriority.at(priority);
 }
 
+int PluginList::getIndexByHandle(TESFileHandle handle) const
+{
+  return handle >= 0 && handle < m_PluginsByHandle.size() ? m_PluginsByHandle[handle]
+                                                          : -1;
+}
+
 QString PluginList::getOriginName(int index) const
 {
   if (index < 0 || index >= m_Plugins.size()) {
@@ -130,69 +142,380 @@ const FileInfo* PluginList::findPlugin(const QString& name) const
 
 FileEntry* PluginList::findEntryByName(const std::string& pluginName) const
 {
-  std::shared_lock lk{m_FileEntryMutex};
+  const auto lk = m_Freeze.readLock(m_FileEntryMutex);
   const auto it = m_EntriesByName.find(pluginName);
   return it != m_EntriesByName.end() ? it->second.get() : nullptr;
 }
 
 FileEntry* PluginList::findEntryByHandle(TESFileHandle handle) const
 {
-  std::shared_lock lk{m_FileEntryMutex};
+  const auto lk = m_Freeze.readLock(m_FileEntryMutex);
   const auto it = m_EntriesByHandle.find(handle);
   return it != m_EntriesByHandle.end() ? it->second.get() : nullptr;
 }
 
+FileEntry* PluginList::findEntryByFile(FileId file) const
+{
+  const auto lk = m_Freeze.readLock(m_FileEntryMutex);
+  return file < m_EntriesByFile.size() ? m_EntriesByFile[file].get() : nullptr;
+}
+
+Record* PluginList::findRecord(FileId file, std::uint32_t objectId) const
+{
+  return m_FormIds.find(file, objectId);
+}
+
 AssociatedEntry* PluginList::findArchive(const QString& name) const
 {
-  std::shared_lock lk{m_ArchiveEntryMutex};
+  const auto lk = m_Freeze.readLock(m_ArchiveEntryMutex);
   const auto it = m_Archives.find(name);
   return it != m_Archives.end() ? it->second.get() : nullptr;
 }
 
+Record::Winner PluginList::recordWinner(const Record& record) const
+{
+  if (const auto winner = record.winner(m_LoadOrderStamp)) {
+    return *winner;
+  }
+
+  const auto alternatives    = record.alternatives();
+  std::uint16_t winnerIndex  = 0;
+  std::uint16_t enabledCount = 0;
+  int winnerPriority         = -1;
+  for (std::size_t i = 0; i < alternatives.size(); ++i) {
+    const int index = getIndexByHandle(alternatives[i]);
+    if (index == -1 || !m_Plugins[index]->enabled()) {
+      continue;
+    }
+
+    ++enabledCount;
+    if (m_Plugins[index]->priority() > winnerPriority) {
+      winnerPriority = m_Plugins[index]->priority();
+      winnerIndex    = static_cast<std::uint16_t>(i);
+    }
+  }
+
+  record.setWinner(m_LoadOrderStamp, winnerIndex, enabledCount);
+  return *record.winner(m_LoadOrderStamp);
+}
+
 FileEntry* PluginList::createEntry(const std::string& name)
 {
+  return createEntry(FileNames::intern(name));
+}
+
+FileEntry* PluginList::createEntry(FileId file)
+{
+  if (const auto entry = findEntryByFile(file)) {
+    return entry;
+  }
+
   std::unique_lock lk{m_FileEntryMutex};
 
-  const auto it = m_EntriesByName.find(name);
-  if (it != m_EntriesByName.end()) {
-    return it->second.get();
+  if (file < m_EntriesByFile.size() && m_EntriesByFile[file]) {
+    return m_EntriesByFile[file].get();
   }
 
+  const auto& name = FileNames::name(file);
   const auto entry = std::make_shared<FileEntry>(m_NextHandle++, name);
   m_EntriesByHandle.emplace_hint(m_EntriesByHandle.cend(), entry->handle(), entry);
   m_EntriesByName[name] = entry;
+
+  if (file >= m_EntriesByFile.size()) {
+    m_EntriesByFile.resize(file + 1);
+  }
+  m_EntriesByFile[file] = entry;
   return entry.get();
 }
 
-void PluginList::addRecordConflict(const std::string& pluginName,
-                                   const RecordPath& path, TESFile::Type type,
-                                   const std::string& name)
+void PluginList::addRecordConflict(FileId plugin, const RecordPath& path,
+                                   TESFile::Type type, const std::string& name)
 {
-  const auto& master = path.hasFormId() ? path.files()[path.formId() >> 24] : "";
-  const auto owner   = createEntry(master);
-  const auto record  = owner->createRecord(path, name, type);
-  if (pluginName != master) {
-    const auto entry = createEntry(pluginName);
+  const FileId master =
+      path.hasFormId() ? path.files()[path.formId() >> 24] : FileNames::None;
+  const auto owner    = createEntry(master);
+  const auto record   = owner->createRecord(path, name, type, plugin == master);
+  if (path.hasFormId()) {
+    m_FormIds.insert(master, path.formId(), record);
+  }
+  if (plugin != master) {
+    const auto entry = createEntry(plugin);
     entry->addRecord(path, name, type, record);
   }
 }
 
-void PluginList::addGroupPlaceholder(const std::string& pluginName,
-                                     const RecordPath& path)
+void PluginList::setOffsetIndex(const std::string& pluginName,
+                                std::shared_ptr<const TESFile::OffsetIndex> index)
+{
+  std::unique_lock lk{m_OffsetIndexMutex};
+  m_OffsetIndices[pluginName] = std::move(index);
+}
+
+// Converts a form ID relative to `files` into the numbering used inside a plugin
+static std::optional<std::uint32_t> localFormId(std::uint32_t formId,
+                                                std::span<const FileId> files,
+                                                const std::string& pluginName,
+                                                const QStringList& masters)
+{
+  const std::string& owner = FileNames::name(files[formId >> 24U]);
+
+  std::uint32_t localIndex;
+  if (TESFile::iequals(owner, pluginName)) {
+    localIndex = static_cast<std::uint32_t>(masters.size());
+  } else {
+    const auto it = TESFile::find(masters, owner, &QString::toStdString);
+    if (it == std::end(masters)) {
+      return std::nullopt;
+    }
+    localIndex = static_cast<std::uint32_t>(std::distance(std::begin(masters), it));
+  }
+
+  return (formId & 0xFFFFFFU) | (localIndex << 24U);
+}
+
+std::optional<TESFile::OffsetIndex::Location>
+PluginList::locate(const std::string& pluginName, const std::filesystem::path& filePath,
+                   const RecordPath& path,
+                   std::optional<TESFile::GroupType> childGroup) const
 {
-  const auto group   = path.groups().back();
-  const auto& master = group.hasParent() ? path.files()[group.parent() >> 24] : "";
-  if (const auto owner = findEntryByName(master)) {
+  std::shared_ptr<const TESFile::OffsetIndex> index;
+  {
+    std::shared_lock lk{m_OffsetIndexMutex};
+    const auto it = m_OffsetIndices.find(pluginName);
+    if (it != m_OffsetIndices.end()) {
+      index = it->second;
+    }
+  }
+
+  const auto plugin = findPlugin(QString::fromStdString(pluginName));
+  if (!plugin) {
+    return std::nullopt;
+  }
+
+  const auto& masters = plugin->masters();
+
+  if (!index || !index->isCurrent(filePath)) {
+    if (!path.hasFormId()) {
+      return std::nullopt;
+    }
+
+    const auto formId = localFormId(path.formId(), path.files(), pluginName, masters);
+    if (!formId) {
+      return std::nullopt;
+    }
+
+    const TESFile::HeaderScanner::Target target{*formId, childGroup};
+    const TESFile::MappedFile file{filePath};
+    return TESFile::HeaderScanner({&target, 1}).scan(file.view()).front();
+  }
+
+  if (path.hasFormId()) {
+    if (const auto formId =
+            localFormId(path.formId(), path.files(), pluginName, masters)) {
+      const auto location =
+          childGroup ? index->findGroup(TESFile::GroupData(*formId, *childGroup))
+                     : index->findForm(*formId);
+      if (location) {
+        return location;
+      }
+    }
+  }
+
+  // records inside skipped groups are not indexed, so fall back to the innermost
+  // group on the path that can be found
+  const auto groups = path.groups();
+  for (auto it = groups.rbegin(); it != groups.rend(); ++it) {
+    TESFile::GroupData group = *it;
+    if (group.hasParent()) {
+      const auto parent = localFormId(group.parent(), path.files(), pluginName, masters);
+      if (!parent) {
+        continue;
+      }
+      group = TESFile::GroupData(*parent, group.type());
+    } else if (!group.hasFormType()) {
+      continue;
+    }
+
+    if (auto location = index->findGroup(group)) {
+      return location;
+    }
+  }
+
+  return std::nullopt;
+}
+
+void PluginList::addGroupPlaceholder(FileId plugin, const RecordPath& path)
+{
+  const auto group    = path.groups().back();
+  const FileId master =
+      group.hasParent() ? path.files()[group.parent() >> 24] : FileNames::None;
+  if (const auto owner = findEntryByFile(master)) {
     owner->addChildGroup(path);
   }
-  if (pluginName != master) {
-    if (const auto entry = findEntryByName(pluginName)) {
+  if (plugin != master) {
+    if (const auto entry = findEntryByFile(plugin)) {
       entry->addChildGroup(path);
     }
   }
 }
 
+void PluginList::finalizeEntries()
+{
+  std::shared_lock lk{m_FileEntryMutex};
+  for (const auto& [name, entry] : m_EntriesByName) {
+    entry->finalize();
+  }
+}
+
+void PluginList::freezeIndex()
+{
+  {
+    std::shared_lock lk{m_FileEntryMutex};
+    for (const auto& [name, entry] : m_EntriesByName) {
+      entry->freeze();
+    }
+  }
+
+  {
+    std::shared_lock lk{m_ArchiveEntryMutex};
+    m_MasterArchiveEntry->freeze();
+    for (const auto& [name, entry] : m_Archives) {
+      entry->freeze();
+    }
+  }
+
+  m_Freeze.freeze();
+}
+
+void PluginList::thawIndex()
+{
+  m_Freeze.thaw();
+
+  {
+    std::shared_lock lk{m_FileEntryMutex};
+    for (const auto& [name, entry] : m_EntriesByName) {
+      entry->thaw();
+    }
+  }
+
+  {
+    std::shared_lock lk{m_ArchiveEntryMutex};
+    if (m_MasterArchiveEntry) {
+      m_MasterArchiveEntry->thaw();
+    }
+    for (const auto& [name, entry] : m_Archives) {
+      entry->thaw();
+    }
+  }
+}
+
 #pragma endregion Record Access
+#pragma region Conflicts
+
+uint PluginList::workerBudget()
+{
+  static const uint budget = std::max(1U, std::thread::hardware_concurrency() / 2);
+  return budget;
+}
+
+void PluginList::computeConflicts()
+{
+  cancelConflicts();
+
+  std::vector<std::shared_ptr<FileEntry>> entries;
+  entries.reserve(m_EntriesByHandle.size());
+  for (const auto& entry : m_EntriesByHandle | std::views::values) {
+    entries.push_back(entry);
+  }
+
+  const auto archives = m_MasterArchiveEntry;
+  if (!archives) {
+    return;
+  }
+
+  const auto pass = std::make_shared<ConflictPass>();
+  m_ConflictPass  = pass;
+  m_ConflictTask  = std::async(std::launch::async, [this, pass, archives,
+                                                   entries = std::move(entries)] {
+    // the pass spreads over the slots that are free when it starts, so that it never
+    // runs more threads than the budget alongside a scan
+    m_Workers.acquire();
+    uint threads = 1;
+    while (threads < workerBudget() && m_Workers.try_acquire()) {
+      ++threads;
+    }
+
+    pass->matrix = ConflictMatrix::build(entries, *archives, threads, pass->cancelled);
+    m_Workers.release(threads);
+
+    if (pass->matrix) {
+      QMetaObject::invokeMethod(
+          this,
+          [this, pass] {
+            publishConflicts(pass);
+          },
+          Qt::QueuedConnection);
+    }
+  });
+}
+
+void PluginList::cancelConflicts()
+{
+  if (!m_ConflictPass) {
+    return;
+  }
+
+  m_ConflictPass->cancelled = true;
+  m_ConflictTask.wait();
+  m_ConflictPass = nullptr;
+}
+
+void PluginList::invalidateConflicts()
+{
+  for (const auto& plugin : m_Plugins) {
+    plugin->invalidateConflicts();
+  }
+}
+
+void PluginList::reorderConflicts(const std::vector<int>& ids)
+{
+  if (!m_ConflictMatrix) {
+    return;
+  }
+
+  const bool ignoreMasters =
+      Settings::instance()->get<bool>("ignore_master_conflicts", false);
+
+  // only the pairs including a moved plugin can have changed order, and only the
+  // plugins sharing something with it are in its row
+  for (const int id : ids) {
+    const auto& plugin = m_Plugins[id];
+    plugin->invalidateConflicts();
+
+    for (const auto& [handle, overlap] : m_ConflictMatrix->row(plugin->handle())) {
+      const int otherIndex = getIndexByHandle(handle);
+      if (otherIndex != -1) {
+        m_Plugins[otherIndex]->updateConflict(*plugin, overlap, ignoreMasters);
+      }
+    }
+  }
+}
+
+void PluginList::publishConflicts(const std::shared_ptr<ConflictPass>& pass)
+{
+  if (pass != m_ConflictPass) {
+    return;
+  }
+
+  m_ConflictTask.wait();
+  m_ConflictPass   = nullptr;
+  m_ConflictMatrix = pass->matrix;
+
+  invalidateConflicts();
+  emit conflictsComputed();
+}
+
+#pragma endregion Conflicts
 #pragma region List Management
 
 QString PluginList::groupsPath() const
@@ -220,7 +543,12 @@ void PluginList::refresh(bool invalidate)
   MOBase::TimeThis tt{"TESData::PluginList::refresh()"};
 
   m_Refreshing = true;
+  cancelConflicts();
+  m_ConflictMatrix = nullptr;
+  invalidateConflicts();
+  thawIndex();
   scanDataFiles(invalidate);
+  freezeIndex();
   readPluginLists();
 
   if (const auto groupsFile = groupsPath(); !groupsFile.isEmpty()) {
@@ -236,6 +564,8 @@ void PluginList::refresh(bool invalidate)
     writeEmptyTextFile(lockedOrderFile);
   }
 
+  computeConflicts();
+
   m_Refreshing = false;
   m_Refreshed();
 }
@@ -338,16 +668,28 @@ bool PluginList::canMoveToPriority(const std::vector<int>& ids, int newPriority)
       }
     }
 
+    const auto [first, last] = m_LoadOrderGraph.destinations(id, m_Plugins);
+    if (newPriority >= first && newPriority <= last) {
+      continue;
+    }
+
+    // a plugin bounding the move may be moved along with this one
+    if (ids.size() == 1 && first <= priority && priority < last) {
+      return false;
+    }
+
     for (int i = newPriority; i < priority; ++i) {
-      const auto plugin = m_Plugins.at(m_PluginsByPriority.at(i));
-      if (!names.contains(plugin->name()) && pluginToMove->mustLoadAfter(*plugin)) {
+      const int index = m_PluginsByPriority.at(i);
+      if (!names.contains(m_Plugins.at(index)->name()) &&
+          m_LoadOrderGraph.mustLoadAfter(id, index)) {
         return false;
       }
     }
 
     for (int i = priority + 1; i < newPriority; ++i) {
-      const auto plugin = m_Plugins.at(m_PluginsByPriority.at(i));
-      if (!names.contains(plugin->name()) && plugin->mustLoadAfter(*pluginToMove)) {
+      const int index = m_PluginsByPriority.at(i);
+      if (!names.contains(m_Plugins.at(index)->name()) &&
+          m_LoadOrderGraph.mustLoadAfter(index, id)) {
         return false;
       }
     }
@@ -450,12 +792,23 @@ void PluginList::moveToPriority(std::vector<int> ids, int destination, bool disj
     const auto& pluginToMove = m_Plugins[id];
     const int priority       = pluginToMove->priority();
 
+    const auto [first, last] = m_LoadOrderGraph.destinations(id, m_Plugins);
+
     if (nextDestination < priority) {
-      for (int i = priority - 1; i >= nextDestination; --i) {
-        const auto& plugin = m_Plugins.at(m_PluginsByPriority.at(i));
-        if (!names.contains(plugin->name()) && pluginToMove->mustLoadAfter(*plugin)) {
-          nextDestination = i + 1;
-          break;
+      // the plugin bounding the move stops it, unless it is being moved as well
+      if (nextDestination < first) {
+        const auto& bound = m_Plugins.at(m_PluginsByPriority.at(first - 1));
+        if (first <= priority && !names.contains(bound->name())) {
+          nextDestination = first;
+        } else {
+          for (int i = priority - 1; i >= nextDestination; --i) {
+            const int index = m_PluginsByPriority.at(i);
+            if (!names.contains(m_Plugins.at(index)->name()) &&
+                m_LoadOrderGraph.mustLoadAfter(id, index)) {
+              nextDestination = i + 1;
+              break;
+            }
+          }
         }
       }
 
@@ -470,12 +823,21 @@ void PluginList::moveToPriority(std::vector<int> ids, int destination, bool disj
 
       m_PluginsByPriority[newPriority] = id;
       pluginToMove->setPriority(newPriority);
+      m_LoadOrderGraph.updateBounds(id, m_Plugins);
     } else if (nextDestination > priority) {
-      for (int i = priority + 1; i < nextDestination; ++i) {
-        const auto& plugin = m_Plugins.at(m_PluginsByPriority.at(i));
-        if (!names.contains(plugin->name()) && plugin->mustLoadAfter(*pluginToMove)) {
-          nextDestination = i;
-          break;
+      if (nextDestination > last) {
+        const auto& bound = m_Plugins.at(m_PluginsByPriority.at(last));
+        if (last > priority && !names.contains(bound->name())) {
+          nextDestination = last;
+        } else {
+          for (int i = priority + 1; i < nextDestination; ++i) {
+            const int index = m_PluginsByPriority.at(i);
+            if (!names.contains(m_Plugins.at(index)->name()) &&
+                m_LoadOrderGraph.mustLoadAfter(index, id)) {
+              nextDestination = i;
+              break;
+            }
+          }
         }
       }
 
@@ -490,6 +852,7 @@ void PluginList::moveToPriority(std::vector<int> ids, int destination, bool disj
 
       m_PluginsByPriority[newPriority] = id;
       pluginToMove->setPriority(newPriority);
+      m_LoadOrderGraph.updateBounds(id, m_Plugins);
     }
 
     if (disjoint) {
@@ -500,6 +863,11 @@ void PluginList::moveToPriority(std::vector<int> ids, int destination, bool disj
   computeCompileIndices();
   refreshLoadOrder();
 
+  std::erase_if(ids, [&](int id) {
+    return m_Plugins[id]->priority() == priorities[m_Plugins[id]->name()];
+  });
+  reorderConflicts(ids);
+
   boost::container::flat_map<int, std::tuple<QString, int>> movedUp;
   boost::container::flat_map<int, std::tuple<QString, int>, std::greater<int>>
       movedDown;
@@ -686,6 +1054,7 @@ void PluginList::setLoadOrder(const QStringList& pluginList)
   }
 
   updateCache();
+  invalidateConflicts();
 }
 
 bool PluginList::isMaster(const QString& name) const
@@ -924,8 +1293,10 @@ void PluginList::scanDataFiles(bool invalidate)
     m_PluginsByName.clear();
     m_PluginsByPriority.clear();
 
+    m_FormIds.clear();
     m_EntriesByName.clear();
     m_EntriesByHandle.clear();
+    m_EntriesByFile.clear();
     m_NextHandle = 0;
 
     m_MasterArchiveEntry = std::make_shared<AssociatedEntry>();
@@ -985,8 +1356,54 @@ void PluginList::scanDataFiles(bool invalidate)
     }
   }
 
-  const uint concurrency = std::max(1U, std::thread::hardware_concurrency() / 2);
-  std::counting_semaphore smph{concurrency};
+  const uint concurrency = workerBudget();
+  auto& smph             = m_Workers;
+
+  // entries are created before the scan, in name order, so that their handles do not
+  // depend on which worker first reaches a plugin or one of its masters. The master
+  // lists are read on the same budget as the scan rather than one plugin at a time.
+  QStringList entryNames;
+  std::vector<std::future<std::vector<std::string>>> masterLists;
+  for (const auto& filename : availablePlugins) {
+    if (!invalidate && m_PluginsByName.contains(filename)) {
+      continue;
+    }
+
+    entryNames.append(filename);
+    masterLists.push_back(std::async(
+        [&smph, path = m_Organizer->resolvePath(filename).toStdWString()] {
+          smph.acquire();
+          std::vector<std::string> masters;
+          try {
+            MasterListParser handler;
+            TESFile::Reader<MasterListParser> reader{};
+            reader.parse(std::filesystem::path(path), handler);
+            masters = handler.masters();
+          } catch (const std::exception&) {
+            // reported when the plugin is scanned
+          }
+          smph.release();
+          return masters;
+        }));
+  }
+
+  for (auto& masterList : masterLists) {
+    for (const auto& master : masterList.get()) {
+      entryNames.append(QString::fromStdString(master));
+    }
+  }
+
+  std::ranges::stable_sort(entryNames, [](const QString& lhs, const QString& rhs) {
+    return lhs.compare(rhs, Qt::CaseInsensitive) < 0;
+  });
+
+  createEntry(FileNames::None);
+  for (const auto& name : entryNames) {
+    createEntry(name.toStdString());
+  }
+
+  TESFile::ReaderStats totalStats;
+  std::mutex totalStatsMutex;
 
   std::vector<std::shared_future<void>> futures;
   for (const auto& filename : availablePlugins) {
@@ -1013,19 +1430,43 @@ void PluginList::scanDataFiles(bool invalidate)
       smph.release();
     });
 
-    auto fileTask = std::async([=, this, &smph, path = fullPath.toStdWString()] {
+    auto fileTask = std::async([=, this, &smph, &totalStats, &totalStatsMutex,
+                                path = fullPath.toStdWString()] {
+      using Reader = TESFile::Reader<FileConflictParser>;
+
       smph.acquire();
+      uint threads = 1;
 
+      TESFile::ReaderStats stats;
       try {
+        // large plugins are split over the slots that are free at this point, so that
+        // their range workers count against the same budget as the plugin tasks
+        const auto fsPath = std::filesystem::path(path);
+        const auto ranges =
+            std::filesystem::file_size(fsPath) / Reader::ConcurrentGranularity;
+        while (threads < std::min<std::uintmax_t>(ranges, concurrency) &&
+               smph.try_acquire()) {
+          ++threads;
+        }
+
         FileConflictParser handler{this, info.get(), lightPluginsAreSupported,
                                    overridePluginsAreSupported};
-        TESFile::Reader<FileConflictParser> reader{};
-        reader.parse(std::filesystem::path(path), handler);
+        Reader reader{};
+        reader.setStats(&stats);
+        auto index = std::make_shared<TESFile::OffsetIndex>();
+        reader.parseConcurrently(fsPath, handler, threads, index.get());
+        setOffsetIndex(info->name().toStdString(), std::move(index));
       } catch (const std::exception& e) {
         MOBase::log::error("Error parsing \"{}\": {}", path, e.what());
       }
 
-      smph.release();
+      MOBase::log::debug("{}: {}", info->name(), stats.summary());
+      {
+        std::scoped_lock lk{totalStatsMutex};
+        totalStats += stats;
+      }
+
+      smph.release(threads);
     });
 
     futures.push_back(assocTask.share());
@@ -1033,6 +1474,11 @@ void PluginList::scanDataFiles(bool invalidate)
   }
 
   boost::wait_for_all(futures.begin(), futures.end());
+  finalizeEntries();
+
+  if (!futures.empty()) {
+    MOBase::log::debug("all plugins: {}", totalStats.summary());
+  }
 
   if (!invalidate) {
     std::erase_if(m_Plugins, [&](auto&& plugin) {
@@ -1065,8 +1511,7 @@ static void populateArchiveFiles(const std::shared_ptr<AuxItem>& master,
     const auto file = archiveFolder->getFile(i);
 
     const auto conflictItem =
-        master->insert(file->getName())->createMember(file->getFilePath());
-    conflictItem->alternatives.insert(handle);
+        master->insert(file->getName())->createMember(file->getFilePath(), handle);
     entry->insert(file->getName())->setMember(conflictItem);
   }
 
@@ -1225,27 +1670,12 @@ void PluginList::enforcePluginRelationships()
 {
   MOBase::TimeThis tt{"TESData::PluginList::enforcePluginRelationships"};
 
-  for (int i = 0; i < m_PluginsByPriority.size(); ++i) {
-    const int firstIndex    = m_PluginsByPriority[i];
-    const auto& firstPlugin = m_Plugins.at(firstIndex);
-
-    for (int j = i + 1; j < m_PluginsByPriority.size(); ++j) {
-      const int secondIndex    = m_PluginsByPriority[j];
-      const auto& secondPlugin = m_Plugins.at(secondIndex);
-
-      if (firstPlugin->mustLoadAfter(*secondPlugin)) {
-        for (int k = j; k > i + 1; --k) {
-          m_PluginsByPriority[k] = m_PluginsByPriority[k - 1];
-          m_Plugins[m_PluginsByPriority[k]]->setPriority(k);
-        }
-        m_PluginsByPriority[i + 1] = firstIndex;
-        firstPlugin->setPriority(i + 1);
-        m_PluginsByPriority[i] = secondIndex;
-        secondPlugin->setPriority(i);
-        j = i;
-      }
-    }
+  const auto sorted = m_LoadOrderGraph.sort(m_PluginsByPriority, m_Plugins);
+  for (int priority = 0; priority < sorted.size(); ++priority) {
+    m_PluginsByPriority[priority] = sorted[priority];
+    m_Plugins[sorted[priority]]->setPriority(priority);
   }
+  m_LoadOrderGraph.updateBounds(m_Plugins);
 
   computeCompileIndices();
   refreshLoadOrder();
@@ -1272,10 +1702,25 @@ void PluginList::testMasters()
 
 void PluginList::updateCache()
 {
+  // conflict checks find plugins and their masters by the handles of their entries,
+  // which are all created by the time the data files have been scanned
+  const auto handleCount = static_cast<std::size_t>(m_NextHandle.load());
+
   m_PluginsByName.clear();
   m_PluginsByPriority.clear();
   m_PluginsByPriority.resize(m_Plugins.size());
+  m_PluginsByHandle.assign(handleCount, -1);
   for (int i = 0; i < m_Plugins.size(); ++i) {
+    const auto entry = findEntryByName(m_Plugins[i]->name().toStdString());
+
+    boost::dynamic_bitset<> masters{handleCount};
+    for (const auto& master : m_Plugins[i]->masters()) {
+      if (const auto masterEntry = findEntryByName(master.toStdString())) {
+        masters.set(masterEntry->handle());
+      }
+    }
+    m_Plugins[i]->setHandles(entry ? entry->handle() : -1, std::move(masters));
+
     if (m_Plugins[i]->priority() < 0) {
       continue;
     }
@@ -1285,8 +1730,15 @@ void PluginList::updateCache()
     }
     m_PluginsByName[m_Plugins[i]->name()]         = i;
     m_PluginsByPriority[m_Plugins[i]->priority()] = i;
+    if (entry) {
+      m_PluginsByHandle[entry->handle()] = i;
+    }
   }
 
+  m_LoadOrderGraph = LoadOrderGraph(m_Plugins, [this](const QString& name) {
+    return getIndex(name);
+  });
+
   computeCompileIndices();
   refreshLoadOrder();
 }
@@ -1333,6 +1785,8 @@ void PluginList::computeCompileIndices()
 
 void PluginList::refreshLoadOrder()
 {
+  ++m_LoadOrderStamp;
+
   int loadOrder = 0;
   for (int i = 0; i < m_PluginsByPriority.size(); ++i) {
     int index          = m_PluginsByPriority[i];
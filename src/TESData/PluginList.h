@@ -2,9 +2,14 @@
 #define TESDATA_PLUGINLIST_H
 
 #include "AssociatedEntry.h"
+#include "ConflictMatrix.h"
 #include "FileEntry.h"
 #include "FileInfo.h"
+#include "FormIdTable.h"
+#include "FreezeState.h"
+#include "LoadOrderGraph.h"
 #include "MOTools/ILootCache.h"
+#include "TESFile/OffsetIndex.h"
 #include "TESFile/Type.h"
 
 #include <gameplugins.h>
@@ -19,8 +24,12 @@
 #include <QObject>
 
 #include <atomic>
+#include <filesystem>
+#include <future>
 #include <map>
 #include <memory>
+#include <optional>
+#include <semaphore>
 #include <set>
 #include <shared_mutex>
 #include <string>
@@ -58,19 +67,69 @@ public:
   [[nodiscard]] const FileInfo* getPluginByPriority(int priority) const;
   [[nodiscard]] int getIndex(const QString& pluginName) const;
   [[nodiscard]] int getIndexAtPriority(int priority) const;
+  [[nodiscard]] int getIndexByHandle(TESFileHandle handle) const;
   [[nodiscard]] QString getOriginName(int index) const;
 
   [[nodiscard]] FileEntry* findEntryByName(const std::string& pluginName) const;
   [[nodiscard]] FileEntry* findEntryByHandle(TESFileHandle handle) const;
+  [[nodiscard]] FileEntry* findEntryByFile(FileId file) const;
+
+  // Finds the record of a form by its owning file and object ID
+  [[nodiscard]] Record* findRecord(FileId file, std::uint32_t objectId) const;
   [[nodiscard]] AssociatedEntry* findArchive(const QString& name) const;
 
+  // Finds the enabled plugin with the highest priority among those containing
+  // `record`. The result is cached on the record until the load order changes.
+  [[nodiscard]] Record::Winner recordWinner(const Record& record) const;
+
   FileEntry* createEntry(const std::string& name);
-  void addRecordConflict(const std::string& pluginName, const RecordPath& path,
-                         TESFile::Type type, const std::string& name);
-  void addGroupPlaceholder(const std::string& pluginName, const RecordPath& path);
+  FileEntry* createEntry(FileId file);
+  void addRecordConflict(FileId plugin, const RecordPath& path, TESFile::Type type,
+                         const std::string& name);
+  void addGroupPlaceholder(FileId plugin, const RecordPath& path);
+
+  // Puts the records added since the last call in order, see FileEntry::finalize
+  void finalizeEntries();
+
+  // Marks the record and archive index as complete once a refresh has scanned the
+  // data files, so that the thread that owns it can read it without locking. See
+  // FreezeState.
+  void freezeIndex();
+  void thawIndex();
+
+  void setOffsetIndex(const std::string& pluginName,
+                      std::shared_ptr<const TESFile::OffsetIndex> index);
+
+  // Finds where reading a plugin can start in order to reach the record at `path`, or
+  // the child group of the given type under that record. If the plugin has not been
+  // indexed or has changed since, its headers are scanned for the record instead.
+  // Returns nothing if no location is found, in which case the whole file must be
+  // read.
+  [[nodiscard]] std::optional<TESFile::OffsetIndex::Location>
+  locate(const std::string& pluginName, const std::filesystem::path& filePath,
+         const RecordPath& path,
+         std::optional<TESFile::GroupType> childGroup = std::nullopt) const;
 
   void refresh(bool invalidate = false);
 
+  // Counts the records and archive files shared by each pair of plugins on worker
+  // threads, and emits conflictsComputed once the new conflict matrix is in use.
+  // The previous matrix stays in use until then.
+  void computeConflicts();
+
+  // Stops a running conflict count. It must be called before changing anything the
+  // count reads: records, their alternatives or archives.
+  void cancelConflicts();
+
+  // Discards the conflicts of all plugins, to be derived again from the matrix
+  void invalidateConflicts();
+
+  // Overlaps between plugins, or null while they are first being counted
+  [[nodiscard]] const ConflictMatrix* conflictMatrix() const
+  {
+    return m_ConflictMatrix.get();
+  }
+
   void setEnabled(int id, bool enable);
   void setEnabled(const std::vector<int>& ids, bool enable);
   void toggleState(const std::vector<int>& ids);
@@ -126,8 +185,19 @@ public slots:
 
 signals:
   void pluginsListChanged();
+  void conflictsComputed();
 
 private:
+  // Conflict count run by computeConflicts
+  struct ConflictPass
+  {
+    std::shared_ptr<const ConflictMatrix> matrix;
+    std::atomic<bool> cancelled = false;
+  };
+
+  // Threads that scans and the conflict pass may keep busy together
+  [[nodiscard]] static uint workerBudget();
+
   [[nodiscard]] FileInfo* findPlugin(const QString& name);
   [[nodiscard]] const FileInfo* findPlugin(const QString& name) const;
 
@@ -156,6 +226,8 @@ private:
   void updateCache();
   void computeCompileIndices();
   void refreshLoadOrder();
+  void reorderConflicts(const std::vector<int>& ids);
+  void publishConflicts(const std::shared_ptr<ConflictPass>& pass);
 
   const MOBase::IOrganizer* m_Organizer;
 
@@ -163,6 +235,11 @@ private:
 
   std::map<QString, int, MOBase::FileNameComparator> m_PluginsByName;
   std::vector<int> m_PluginsByPriority;
+  std::vector<int> m_PluginsByHandle;
+  LoadOrderGraph m_LoadOrderGraph;
+
+  // changed whenever priorities or enabled states change, see recordWinner
+  std::uint32_t m_LoadOrderStamp = 1;
 
   std::map<QString, MOTools::Loot::Plugin, MOBase::FileNameComparator> m_LootInfo;
 
@@ -170,8 +247,12 @@ private:
   std::map<std::string, std::shared_ptr<FileEntry>, TESFile::less> m_EntriesByName;
   boost::container::flat_map<TESFileHandle, std::shared_ptr<FileEntry>>
       m_EntriesByHandle;
+  std::vector<std::shared_ptr<FileEntry>> m_EntriesByFile;
+  FormIdTable m_FormIds;
   std::map<std::string, std::shared_ptr<Record>> m_Settings;
   std::map<TESFile::Type, std::shared_ptr<Record>> m_DefaultObjects;
+  std::map<std::string, std::shared_ptr<const TESFile::OffsetIndex>, TESFile::less>
+      m_OffsetIndices;
 
   std::shared_ptr<AssociatedEntry> m_MasterArchiveEntry;
   std::map<QString, std::shared_ptr<AssociatedEntry>, MOBase::FileNameComparator>
@@ -179,6 +260,15 @@ private:
 
   mutable std::shared_mutex m_FileEntryMutex;
   mutable std::shared_mutex m_ArchiveEntryMutex;
+  mutable std::shared_mutex m_OffsetIndexMutex;
+  FreezeState m_Freeze;
+
+  std::shared_ptr<const ConflictMatrix> m_ConflictMatrix;
+  std::shared_ptr<ConflictPass> m_ConflictPass;
+  std::future<void> m_ConflictTask;
+
+  // slots of workerBudget() shared by scans and the conflict pass
+  std::counting_semaphore<> m_Workers{workerBudget()};
 
   bool m_Refreshing = true;
   std::map<QString, PluginStates> m_QueuedStateChanges;
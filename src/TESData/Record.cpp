@@ -0,0 +1,127 @@
+#include "Record.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+
+namespace TESData
+{
+
+// Plugins overriding the same record may be scanned at the same time, so adding an
+// alternative locks one of a fixed set of mutexes chosen by the record's address
+static std::mutex& alternativeLock(const Record* record)
+{
+  static std::array<std::mutex, 64> locks;
+  const auto address = reinterpret_cast<std::uintptr_t>(record);
+  return locks[(address / alignof(Record)) % locks.size()];
+}
+
+Record::~Record()
+{
+  if (m_AlternativeCount > InlineAlternatives) {
+    delete[] m_SpilledAlternatives;
+  }
+}
+
+Record::Identifier Record::identifier() const
+{
+  switch (m_IdKind) {
+  case IdKind::FormId:
+    return m_Id;
+  case IdKind::EditorId:
+    return std::string(editorId());
+  case IdKind::TypeId:
+    return typeId();
+  default:
+    return std::monostate();
+  }
+}
+
+std::span<const TESFileHandle> Record::alternatives() const
+{
+  if (m_AlternativeCount <= InlineAlternatives) {
+    return {m_Alternatives.data(), m_AlternativeCount};
+  }
+
+  return {m_SpilledAlternatives, m_AlternativeCount};
+}
+
+std::optional<Record::Winner> Record::winner(std::uint32_t loadOrderStamp) const
+{
+  if (m_WinnerStamp != loadOrderStamp) {
+    return std::nullopt;
+  }
+
+  Winner winner;
+  winner.enabledCount = m_EnabledAlternatives;
+  if (m_EnabledAlternatives != 0) {
+    winner.handle = alternatives()[m_WinnerIndex];
+  }
+  return winner;
+}
+
+void Record::setWinner(std::uint32_t loadOrderStamp, std::uint16_t alternativeIndex,
+                       std::uint16_t enabledCount) const
+{
+  m_WinnerStamp         = loadOrderStamp;
+  m_WinnerIndex         = alternativeIndex;
+  m_EnabledAlternatives = enabledCount;
+}
+
+void Record::setFormId(std::uint32_t formId, std::span<const FileId> files)
+{
+  const std::uint8_t localIndex = formId >> 24U;
+  m_IdKind                      = IdKind::FormId;
+  m_Id                          = formId & ~0xFF000000U;
+  m_File                        = files[localIndex];
+}
+
+void Record::setEditorId(const std::string_view& editorId)
+{
+  m_IdKind   = IdKind::EditorId;
+  m_EditorId = &editorId;
+}
+
+void Record::setTypeId(TESFile::Type typeId)
+{
+  m_IdKind = IdKind::TypeId;
+  m_Id     = typeId.value;
+}
+
+void Record::addAlternative(TESFileHandle origin)
+{
+  std::scoped_lock lk{alternativeLock(this)};
+  m_WinnerStamp = 0;
+
+  const bool spilled = m_AlternativeCount > InlineAlternatives;
+  const auto begin    = spilled ? m_SpilledAlternatives : m_Alternatives.data();
+  const auto end      = begin + m_AlternativeCount;
+  const auto it       = std::lower_bound(begin, end, origin);
+  if (it != end && *it == origin) {
+    return;
+  }
+
+  // a spilled array is full whenever the count reaches a power of two
+  const bool full = spilled ? std::has_single_bit(m_AlternativeCount)
+                            : m_AlternativeCount == InlineAlternatives;
+  if (full) {
+    const auto list = new TESFileHandle[std::size_t{m_AlternativeCount} * 2];
+    const auto next = std::move(begin, it, list);
+    *next           = origin;
+    std::move(it, end, next + 1);
+
+    if (spilled) {
+      delete[] begin;
+    }
+    m_SpilledAlternatives = list;
+  } else {
+    std::move_backward(it, end, end + 1);
+    *it = origin;
+  }
+
+  ++m_AlternativeCount;
+}
+
+}  // namespace TESData
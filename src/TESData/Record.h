@@ -1,88 +1,136 @@
 #ifndef TESDATA_RECORD_H
 #define TESDATA_RECORD_H
 
+#include "FileNames.h"
 #include "TESFile/Type.h"
 
-#include <QString>
-
-#include <set>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <span>
+#include <string>
+#include <string_view>
+#include <variant>
 
 namespace TESData
 {
 
 using TESFileHandle = int;
 
+// A record as seen across the load order. Records are kept for every form in every
+// plugin, so this is a small struct: the editor ID is not copied, and the list of
+// plugins containing the record is stored inline until it outgrows the buffer and
+// moves to an array owned by the record. Records are owned by the file entry that
+// created them, and do not move.
 class Record final
 {
 public:
   using Identifier =
       std::variant<std::monostate, std::uint32_t, std::string, TESFile::Type>;
 
+  static constexpr std::size_t InlineAlternatives = 4;
+
+  // The enabled alternative with the highest priority, and the number of enabled
+  // alternatives
+  struct Winner
+  {
+    TESFileHandle handle       = -1;
+    std::uint16_t enabledCount = 0;
+  };
+
+  Record() = default;
+  ~Record();
+
+  Record(const Record&)            = delete;
+  Record& operator=(const Record&) = delete;
+
   [[nodiscard]] TESFile::Type formType() const { return m_FormType; }
 
-  [[nodiscard]] const std::string& file() const { return m_File; }
+  [[nodiscard]] FileId file() const { return m_File; }
+  [[nodiscard]] const std::string& fileName() const { return FileNames::name(m_File); }
 
-  [[nodiscard]] const Identifier& identifier() const { return m_Identifier; }
+  [[nodiscard]] Identifier identifier() const;
 
-  [[nodiscard]] bool hasFormId() const
-  {
-    return std::holds_alternative<std::uint32_t>(m_Identifier);
-  }
+  [[nodiscard]] bool hasFormId() const { return m_IdKind == IdKind::FormId; }
+  [[nodiscard]] bool hasEditorId() const { return m_IdKind == IdKind::EditorId; }
+  [[nodiscard]] bool hasTypeId() const { return m_IdKind == IdKind::TypeId; }
+
+  [[nodiscard]] std::uint32_t formId() const { return m_Id; }
+  [[nodiscard]] std::string_view editorId() const { return *m_EditorId; }
 
-  [[nodiscard]] bool hasEditorId() const
+  [[nodiscard]] TESFile::Type typeId() const
   {
-    return std::holds_alternative<std::string>(m_Identifier);
+    TESFile::Type type;
+    type.value = m_Id;
+    return type;
   }
 
-  [[nodiscard]] bool hasTypeId() const
+  // Handles of the files containing the record, in ascending order
+  [[nodiscard]] std::span<const TESFileHandle> alternatives() const;
+
+  [[nodiscard]] bool ignored() const { return m_Flags & Flag_Ignored; }
+  void setIgnored(bool value)
   {
-    return std::holds_alternative<TESFile::Type>(m_Identifier);
+    m_Flags = value ? (m_Flags | Flag_Ignored) : (m_Flags & ~Flag_Ignored);
   }
 
-  [[nodiscard]] std::uint32_t formId() const
+  // `formId` is relative to `files`
+  void setFormId(std::uint32_t formId, std::span<const FileId> files);
+
+  // The editor ID is not copied, and must outlive the record
+  void setEditorId(const std::string_view& editorId);
+
+  void setTypeId(TESFile::Type typeId);
+
+  void addAlternative(TESFileHandle origin);
+
+  // Returns the winner cached for the load order identified by `loadOrderStamp`, if
+  // any. The plugin list computes and caches winners on the GUI thread.
+  [[nodiscard]] std::optional<Winner> winner(std::uint32_t loadOrderStamp) const;
+  void setWinner(std::uint32_t loadOrderStamp, std::uint16_t alternativeIndex,
+                 std::uint16_t enabledCount) const;
+
+private:
+  enum class IdKind : std::uint8_t
   {
-    return std::get<std::uint32_t>(m_Identifier);
-  }
+    None,
+    FormId,
+    EditorId,
+    TypeId,
+  };
 
-  [[nodiscard]] const std::string& editorId() const
+  enum Flag : std::uint8_t
   {
-    return std::get<std::string>(m_Identifier);
-  }
+    Flag_Ignored = 0x1,
+  };
 
-  [[nodiscard]] TESFile::Type typeId() const
+  // inline until there are more than fit, then an array with room for the next power
+  // of two
+  union
   {
-    return std::get<TESFile::Type>(m_Identifier);
-  }
+    std::array<TESFileHandle, InlineAlternatives> m_Alternatives{};
+    TESFileHandle* m_SpilledAlternatives;
+  };
 
-  [[nodiscard]] const std::set<TESFileHandle>& alternatives() const
+  // form ID without the file index, type ID, or editor ID
+  union
   {
-    return m_Alternatives;
-  }
+    std::uint32_t m_Id = 0;
+    const std::string_view* m_EditorId;
+  };
 
-  [[nodiscard]] bool ignored() const { return m_Ignored; }
-  void setIgnored(bool value) { m_Ignored = value; }
+  TESFile::Type m_FormType{};
 
-  void setIdentifier(const Identifier& identifier, std::span<const std::string> files)
-  {
-    m_Identifier = identifier;
-
-    if (std::holds_alternative<std::uint32_t>(m_Identifier)) {
-      std::uint32_t& formId         = std::get<std::uint32_t>(m_Identifier);
-      const std::uint8_t localIndex = formId >> 24U;
-      formId &= ~0xFF000000U;
-      m_File = files[localIndex];
-    }
-  }
+  FileId m_File        = FileNames::None;
+  IdKind m_IdKind      = IdKind::None;
+  std::uint8_t m_Flags = 0;
 
-  void addAlternative(TESFileHandle origin) { m_Alternatives.insert(origin); }
+  std::uint16_t m_AlternativeCount = 0;
 
-private:
-  TESFile::Type m_FormType;
-  std::string m_File;
-  Identifier m_Identifier;
-  std::set<TESFileHandle> m_Alternatives;
-  bool m_Ignored = false;
+  // winner cache, stored as an index into the alternatives to keep records small
+  mutable std::uint32_t m_WinnerStamp         = 0;
+  mutable std::uint16_t m_WinnerIndex         = 0;
+  mutable std::uint16_t m_EnabledAlternatives = 0;
 };
 
 }  // namespace TESData
@@ -23,7 +23,7 @@ std::string RecordPath::string() const
           m_Groups[i - 1].parent() != group.parent()) {
         const auto parentId           = group.parent();
         const std::uint8_t localIndex = parentId >> 24U;
-        const std::string& owner      = m_Files.at(localIndex);
+        const std::string& owner      = FileNames::name(m_Files.at(localIndex));
         ss << owner << "|";
         ss << std::hex << std::setfill('0') << std::setw(6) << (parentId & 0xFFFFFF);
         ss << "/";
@@ -51,7 +51,7 @@ std::string RecordPath::string() const
   if (hasFormId()) {
     const auto id                 = formId();
     const std::uint8_t localIndex = id >> 24U;
-    const std::string& owner      = m_Files.at(localIndex);
+    const std::string& owner      = FileNames::name(m_Files.at(localIndex));
     ss << owner << "|";
     ss << std::hex << std::setfill('0') << std::setw(6) << (id & 0xFFFFFF);
   } else if (hasEditorId()) {
@@ -63,13 +63,13 @@ std::string RecordPath::string() const
   return ss.str();
 }
 
-void RecordPath::setFormId(std::uint32_t formId, std::span<const std::string> masters,
-                           const std::string& file)
+void RecordPath::setFormId(std::uint32_t formId, std::span<const FileId> masters,
+                           FileId file)
 {
   const std::uint8_t localIndex = formId >> 24U;
-  const std::string& owner = localIndex < masters.size() ? masters[localIndex] : file;
+  const FileId owner = localIndex < masters.size() ? masters[localIndex] : file;
   const std::uint8_t newIndex = static_cast<std::uint8_t>(
-      std::distance(std::begin(m_Files), TESFile::find(m_Files, owner)));
+      std::distance(std::begin(m_Files), std::ranges::find(m_Files, owner)));
 
   if (newIndex == m_Files.size()) {
     m_Files.push_back(owner);
@@ -104,24 +104,24 @@ void RecordPath::setTypeId(TESFile::Type type)
 }
 
 void RecordPath::setIdentifier(const Identifier& identifier,
-                               std::span<const std::string> masters)
+                               std::span<const FileId> masters)
 {
   if (std::holds_alternative<std::uint32_t>(identifier)) {
-    setFormId(std::get<std::uint32_t>(identifier), masters, "");
+    setFormId(std::get<std::uint32_t>(identifier), masters, FileNames::None);
   } else {
     unsetFormId();
     m_Identifier = identifier;
   }
 }
 
-void RecordPath::push(TESFile::GroupData group, std::span<const std::string> masters,
-                      const std::string& file)
+void RecordPath::push(TESFile::GroupData group, std::span<const FileId> masters,
+                      FileId file)
 {
   if (group.hasParent()) {
     const std::uint8_t localIndex = group.parent() >> 24U;
-    const std::string& owner = localIndex < masters.size() ? masters[localIndex] : file;
+    const FileId owner = localIndex < masters.size() ? masters[localIndex] : file;
     const std::uint8_t newIndex = static_cast<std::uint8_t>(
-        std::distance(std::begin(m_Files), TESFile::find(m_Files, owner)));
+        std::distance(std::begin(m_Files), std::ranges::find(m_Files, owner)));
 
     if (newIndex == m_Files.size()) {
       m_Files.push_back(owner);
@@ -1,6 +1,7 @@
 #ifndef TESDATA_RECORDPATH_H
 #define TESDATA_RECORDPATH_H
 
+#include "FileNames.h"
 #include "TESFile/Stream.h"
 
 #include <boost/container/small_vector.hpp>
@@ -49,16 +50,21 @@ public:
     return std::get<TESFile::Type>(m_Identifier);
   }
 
-  [[nodiscard]] std::span<const std::string> files() const { return m_Files; }
+  [[nodiscard]] std::span<const FileId> files() const
+  {
+    return {m_Files.data(), m_Files.size()};
+  }
 
-  [[nodiscard]] std::span<const TESFile::GroupData> groups() const { return m_Groups; }
+  [[nodiscard]] std::span<const TESFile::GroupData> groups() const
+  {
+    return {m_Groups.data(), m_Groups.size()};
+  }
 
   [[nodiscard]] const auto& identifier() const { return m_Identifier; }
 
   [[nodiscard]] std::string string() const;
 
-  void setFormId(std::uint32_t formId, std::span<const std::string> masters,
-                 const std::string& file);
+  void setFormId(std::uint32_t formId, std::span<const FileId> masters, FileId file);
 
   void unsetFormId();
 
@@ -66,17 +72,16 @@ public:
 
   void setTypeId(TESFile::Type type);
 
-  void setIdentifier(const Identifier& identifier, std::span<const std::string> files);
+  void setIdentifier(const Identifier& identifier, std::span<const FileId> files);
 
-  void push(TESFile::GroupData group, const std::span<const std::string> masters,
-            const std::string& file);
+  void push(TESFile::GroupData group, std::span<const FileId> masters, FileId file);
 
   void pop();
 
 private:
   void cleanLastFile();
 
-  boost::container::small_vector<std::string, 2> m_Files;
+  boost::container::small_vector<FileId, 4> m_Files;
   boost::container::small_vector<TESFile::GroupData, 4> m_Groups;
   Identifier m_Identifier;
 };
@@ -47,10 +47,14 @@ SingleRecordParser::SingleRecordParser(const QString& gameName, const RecordPath
       m_FileIndex{index}
 {}
 
-bool SingleRecordParser::Group(TESFile::GroupData group)
+TESFile::Traversal SingleRecordParser::Group(TESFile::GroupData group)
 {
+  if (m_RecordFound || m_BranchClosed) {
+    return TESFile::Traversal::Stop;
+  }
+
   if (m_Depth == m_Path.groups().size()) {
-    return false;
+    return TESFile::Traversal::Skip;
   }
 
   if (group.hasParent()) {
@@ -58,22 +62,33 @@ bool SingleRecordParser::Group(TESFile::GroupData group)
     const std::string& owner =
         localIndex < m_Masters.size() ? m_Masters[localIndex] : m_File;
     const auto files            = m_Path.files();
-    const std::uint8_t newIndex = static_cast<std::uint8_t>(
-        std::distance(std::begin(files), TESFile::find(files, owner)));
+    const std::uint8_t newIndex = static_cast<std::uint8_t>(std::distance(
+        std::begin(files), std::ranges::find(files, FileNames::intern(owner))));
 
     group.setLocalIndex(newIndex);
   }
 
   if (group == m_Path.groups()[m_Depth]) {
     ++m_Depth;
-    return true;
+    return TESFile::Traversal::Descend;
   }
 
-  return false;
+  return TESFile::Traversal::Skip;
 }
 
-bool SingleRecordParser::Form(TESFile::FormData form)
+void SingleRecordParser::EndGroup()
 {
+  // only groups on the path to the record are entered, and the record cannot appear
+  // after any of them has ended
+  m_BranchClosed = true;
+}
+
+TESFile::Traversal SingleRecordParser::Form(TESFile::FormData form)
+{
+  if (m_RecordFound || m_BranchClosed) {
+    return TESFile::Traversal::Stop;
+  }
+
   m_CurrentType  = form.type();
   m_CurrentFlags = form.flags();
 
@@ -82,31 +97,29 @@ bool SingleRecordParser::Form(TESFile::FormData form)
       m_Localized = (form.flags() & TESFile::RecordFlags::Localized);
     }
 
-    return true;
+    return TESFile::Traversal::Descend;
   }
 
   if (m_Path.hasFormId()) {
     if ((form.formId() & 0xFFFFFF) != (m_Path.formId() & 0xFFFFFF)) {
-      return false;
+      return TESFile::Traversal::Skip;
     }
 
     const std::uint8_t localIndex = form.formId() >> 24U;
     const std::string& owner =
         localIndex < m_Masters.size() ? m_Masters[localIndex] : m_File;
-    if (!TESFile::iequals(m_Path.files()[m_Path.formId() >> 24U], owner)) {
-      return false;
+    if (m_Path.files()[m_Path.formId() >> 24U] != FileNames::intern(owner)) {
+      return TESFile::Traversal::Skip;
     }
 
     m_RecordFound   = true;
     const auto game = gameIdentifier(m_GameName);
     FormParserManager::getParser(game, m_CurrentType)
         ->parseFlags(m_DataRoot, m_FileIndex, m_CurrentFlags);
-    return true;
-  } else {
-    return !m_RecordFound;
+    return TESFile::Traversal::Descend;
   }
 
-  return false;
+  return TESFile::Traversal::Descend;
 }
 
 bool SingleRecordParser::Chunk(TESFile::Type type)
@@ -115,22 +128,20 @@ bool SingleRecordParser::Chunk(TESFile::Type type)
   return true;
 }
 
-void SingleRecordParser::Data(std::istream& stream)
+void SingleRecordParser::Data(TESFile::Cursor& data)
 {
-  m_ChunkStream = &stream;
-
   if (m_Depth == 0) {
     if (m_CurrentChunk == "MAST"_ts) {
-      const std::string master = TESFile::readZstring(stream);
+      const std::string_view master = TESFile::readZstring(data);
       if (!master.empty()) {
-        m_Masters.push_back(master);
+        m_Masters.emplace_back(master);
       }
     }
     return;
   }
 
   if (m_Path.hasEditorId() && m_CurrentChunk == "EDID"_ts) {
-    const std::string editorId = TESFile::readZstring(stream);
+    const std::string_view editorId = TESFile::readZstring(data);
     if (editorId != m_Path.editorId()) {
       return;
     }
@@ -139,13 +150,13 @@ void SingleRecordParser::Data(std::istream& stream)
     const auto game = gameIdentifier(m_GameName);
     FormParserManager::getParser(game, m_CurrentType)
         ->parseFlags(m_DataRoot, m_FileIndex, m_CurrentFlags);
-    stream.seekg(std::ios::beg);
+    data.seek(0);
   }
 
   if (m_Path.hasTypeId() && m_CurrentChunk == "DNAM"_ts) {
-    while (stream.peek() != std::char_traits<char>::eof()) {
-      const TESFile::Type name   = TESFile::readType<TESFile::Type>(stream);
-      const QString formIdString = readFormId(m_Masters, m_File, stream);
+    while (!data.atEnd()) {
+      const TESFile::Type name   = TESFile::readType<TESFile::Type>(data);
+      const QString formIdString = readFormId(m_Masters, m_File, data);
       if (name == m_Path.typeId()) {
         m_DataRoot->getOrInsertChild(0, name, u""_s)
             ->setData(m_FileIndex, formIdString);
@@ -163,6 +174,13 @@ void SingleRecordParser::Data(std::istream& stream)
     return;
   }
 
+  // the generated form parsers still consume streams, so only the matched record
+  // pays for one
+  TESFile::ViewStreamBuf buffer{data.view()};
+  std::istream stream{&buffer};
+  stream.exceptions(std::ios_base::failbit);
+  m_ChunkStream = &stream;
+
   if (!m_ParseTask) {
     const auto game = gameIdentifier(m_GameName);
     m_ParseTask     = FormParserManager::getParser(game, m_CurrentType)
@@ -173,6 +191,8 @@ void SingleRecordParser::Data(std::istream& stream)
   if (!m_ParseTask.done()) {
     m_ParseTask.resume();
   }
+
+  m_ChunkStream = nullptr;
 }
 
 }  // namespace TESData
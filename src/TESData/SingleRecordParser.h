@@ -3,6 +3,7 @@
 
 #include "DataItem.h"
 #include "RecordPath.h"
+#include "TESFile/Cursor.h"
 #include "TESFile/Stream.h"
 
 #include <iplugingame.h>
@@ -23,10 +24,11 @@ public:
   SingleRecordParser(const QString& gameName, const RecordPath& path,
                      const std::string& file, DataItem* root, int index);
 
-  bool Group(TESFile::GroupData group);
-  bool Form(TESFile::FormData form);
+  TESFile::Traversal Group(TESFile::GroupData group);
+  void EndGroup();
+  TESFile::Traversal Form(TESFile::FormData form);
   bool Chunk(TESFile::Type type);
-  void Data(std::istream& stream);
+  void Data(TESFile::Cursor& data);
 
 private:
   QString m_GameName;
@@ -38,12 +40,13 @@ private:
   TESFile::Type m_CurrentType;
   std::uint32_t m_CurrentFlags = 0;
   std::coroutine_handle<> m_ParseTask;
-  std::istream* m_ChunkStream;
+  std::istream* m_ChunkStream = nullptr;
 
   std::vector<std::string> m_Masters;
   int m_Depth           = 0;
   bool m_Localized      = false;
   bool m_RecordFound    = false;
+  bool m_BranchClosed   = false;
   TESFile::Type m_CurrentChunk;
 };
 
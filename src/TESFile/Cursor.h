@@ -0,0 +1,94 @@
+#ifndef TESFILE_CURSOR_H
+#define TESFILE_CURSOR_H
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace TESFile
+{
+
+// Bounds-checked read position over subrecord data. Reads past the end throw instead
+// of returning partial values.
+class Cursor final
+{
+public:
+  explicit Cursor(std::span<const std::byte> data) : data_{data} {}
+
+  [[nodiscard]] std::span<const std::byte> data() const { return data_; }
+
+  [[nodiscard]] std::string_view view() const
+  {
+    return std::string_view(reinterpret_cast<const char*>(data_.data()), data_.size());
+  }
+
+  [[nodiscard]] std::size_t size() const { return data_.size(); }
+  [[nodiscard]] std::size_t position() const { return pos_; }
+  [[nodiscard]] std::size_t remaining() const { return data_.size() - pos_; }
+  [[nodiscard]] bool atEnd() const { return pos_ == data_.size(); }
+
+  void seek(std::size_t position)
+  {
+    if (position > data_.size()) {
+      throw std::out_of_range(
+          fmt::format("Seek past end of subrecord ({}/{})", position, data_.size()));
+    }
+    pos_ = position;
+  }
+
+  void skip(std::size_t count) { static_cast<void>(read(count)); }
+
+  [[nodiscard]] std::span<const std::byte> read(std::size_t count)
+  {
+    if (count > remaining()) {
+      throw std::out_of_range(
+          fmt::format("Read past end of subrecord ({}+{}/{})", pos_, count, size()));
+    }
+    const auto result = data_.subspan(pos_, count);
+    pos_ += count;
+    return result;
+  }
+
+private:
+  std::span<const std::byte> data_;
+  std::size_t pos_ = 0;
+};
+
+template <typename T>
+  requires std::is_trivially_copyable_v<T>
+inline T readType(Cursor& cursor)
+{
+  T value;
+  std::memcpy(&value, cursor.read(sizeof(T)).data(), sizeof(T));
+  return value;
+}
+
+// Returns the characters up to the next null terminator, which is consumed. The view
+// refers to the cursor's underlying data.
+inline std::string_view readZstring(Cursor& cursor)
+{
+  const auto rest = cursor.view().substr(cursor.position());
+  const auto end  = rest.find('\0');
+  if (end == std::string_view::npos) {
+    cursor.skip(rest.size());
+    return rest;
+  } else {
+    cursor.skip(end + 1);
+    return rest.substr(0, end);
+  }
+}
+
+inline std::uint32_t readFormId(Cursor& cursor)
+{
+  return readType<std::uint32_t>(cursor);
+}
+
+}  // namespace TESFile
+
+#endif  // TESFILE_CURSOR_H
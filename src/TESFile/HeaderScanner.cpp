@@ -0,0 +1,136 @@
+#include "HeaderScanner.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define TESFILE_SCANNER_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace TESFile
+{
+
+static constexpr std::size_t CompareWidth = 4;
+
+HeaderScanner::HeaderScanner(std::span<const Target> targets)
+    : targets_(targets.begin(), targets.end())
+{
+  for (const auto& target : targets_) {
+    ids_.push_back(target.id);
+  }
+
+  while (!ids_.empty() && ids_.size() % CompareWidth != 0) {
+    ids_.push_back(ids_.front());
+  }
+}
+
+std::vector<std::optional<OffsetIndex::Location>>
+HeaderScanner::scan(std::string_view data) const
+{
+  std::vector<std::optional<OffsetIndex::Location>> results(targets_.size());
+  if (targets_.empty()) {
+    return results;
+  }
+
+  RecordHeader header;
+  if (data.size() < sizeof(RecordHeader)) {
+    throw std::runtime_error("record incomplete");
+  }
+  std::memcpy(&header, data.data(), sizeof(RecordHeader));
+
+  std::size_t headerSize;
+  if (header.type == "TES4"_ts) {
+    headerSize = header.old.firstChunk == "HEDR"_ts ? 20 : sizeof(RecordHeader);
+  } else {
+    // Morrowind plugins have no groups and are not indexed
+    return results;
+  }
+
+  struct OpenGroup
+  {
+    GroupData group;
+    std::size_t end;
+  };
+  std::vector<OpenGroup> openGroups;
+
+  const auto location = [&](std::size_t offset, Type type, std::uint32_t id) {
+    OffsetIndex::Location result{static_cast<std::uint32_t>(offset), type, id};
+    for (const auto& open : openGroups) {
+      result.ancestors.push_back(open.group);
+    }
+    return result;
+  };
+
+  std::size_t remaining = targets_.size();
+  std::size_t offset    = headerSize + header.dataSize;
+  while (offset < data.size() && remaining != 0) {
+    while (!openGroups.empty() && openGroups.back().end <= offset) {
+      openGroups.pop_back();
+    }
+
+    if (data.size() - offset < headerSize) {
+      throw std::runtime_error("record incomplete");
+    }
+    std::memcpy(&header, data.data() + offset, headerSize);
+
+    if (header.type == "GRUP"_ts) {
+      if (header.dataSize < headerSize || data.size() - offset < header.dataSize) {
+        throw std::runtime_error("group incomplete");
+      }
+
+      const GroupData group{header.groupData.label, header.groupData.groupType};
+      if (mayMatch(header.groupData.label)) {
+        for (std::size_t i = 0; i < targets_.size(); ++i) {
+          if (!results[i] && targets_[i].id == header.groupData.label &&
+              targets_[i].group == group.type()) {
+            results[i] = location(offset, header.type, header.groupData.label);
+            --remaining;
+          }
+        }
+      }
+
+      // step into the group so that its contents are visited next
+      openGroups.push_back({group, offset + header.dataSize});
+      offset += headerSize;
+    } else {
+      if (data.size() - offset - headerSize < header.dataSize) {
+        throw std::runtime_error("record incomplete");
+      }
+
+      if (mayMatch(header.formData.formId)) {
+        for (std::size_t i = 0; i < targets_.size(); ++i) {
+          if (!results[i] && targets_[i].id == header.formData.formId &&
+              !targets_[i].group) {
+            results[i] = location(offset, header.type, header.formData.formId);
+            --remaining;
+          }
+        }
+      }
+
+      offset += headerSize + header.dataSize;
+    }
+  }
+
+  return results;
+}
+
+bool HeaderScanner::mayMatch(std::uint32_t id) const
+{
+#ifdef TESFILE_SCANNER_SSE2
+  const __m128i key = _mm_set1_epi32(static_cast<int>(id));
+  for (std::size_t i = 0; i < ids_.size(); i += CompareWidth) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(ids_.data() + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(block, key)) != 0) {
+      return true;
+    }
+  }
+  return false;
+#else
+  return std::ranges::find(ids_, id) != ids_.end();
+#endif
+}
+
+}  // namespace TESFile
@@ -0,0 +1,49 @@
+#ifndef TESFILE_HEADERSCANNER_H
+#define TESFILE_HEADERSCANNER_H
+
+#include "OffsetIndex.h"
+#include "Stream.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace TESFile
+{
+
+// Finds records and groups in a plugin image by sweeping over their headers once,
+// without reading or inflating any record data. Useful when there is no OffsetIndex
+// for the file, and for looking up many elements of the same file at once.
+class HeaderScanner final
+{
+public:
+  struct Target
+  {
+    // Form ID of a record, or label of a group, as stored in the file
+    std::uint32_t id;
+
+    // Type of the group to find, or nothing to find a record
+    std::optional<GroupType> group;
+  };
+
+  explicit HeaderScanner(std::span<const Target> targets);
+
+  // Returns the location of each target, in the order they were given
+  [[nodiscard]] std::vector<std::optional<OffsetIndex::Location>>
+  scan(std::string_view data) const;
+
+private:
+  // Quick check whether any target has this ID, comparing several targets at once
+  [[nodiscard]] bool mayMatch(std::uint32_t id) const;
+
+  std::vector<Target> targets_;
+
+  // Target IDs padded with repeats to a multiple of the comparison width
+  std::vector<std::uint32_t> ids_;
+};
+
+}  // namespace TESFile
+
+#endif  // TESFILE_HEADERSCANNER_H
@@ -0,0 +1,240 @@
+#include "Inflater.h"
+
+#ifdef TESFILE_INFLATE_LIBDEFLATE
+#include <libdeflate.h>
+#else
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace TESFile
+{
+
+#ifdef TESFILE_INFLATE_LIBDEFLATE
+
+struct Inflater::Backend
+{
+  // libdeflate has no streaming interface, so the whole record is produced on the
+  // first request
+  static constexpr bool Streams = false;
+
+  Backend() : decompressor{::libdeflate_alloc_decompressor()}
+  {
+    if (decompressor == nullptr) {
+      throw std::bad_alloc();
+    }
+  }
+
+  ~Backend() noexcept { ::libdeflate_free_decompressor(decompressor); }
+
+  std::size_t inflate(std::string_view input, char* output, std::size_t size)
+  {
+    std::size_t actualSize = 0;
+    const auto result = ::libdeflate_zlib_decompress(decompressor, input.data(),
+                                                     input.size(), output, size,
+                                                     &actualSize);
+    if (result != LIBDEFLATE_SUCCESS) {
+      throw std::runtime_error("libdeflate failed to read data");
+    }
+    return actualSize;
+  }
+
+  void begin(std::string_view input) { pending = input; }
+
+  std::size_t resume(char* output, std::size_t size, bool& finished)
+  {
+    finished = true;
+    return inflate(std::exchange(pending, {}), output, size);
+  }
+
+  ::libdeflate_decompressor* decompressor;
+  std::string_view pending;
+};
+
+#else
+
+struct Inflater::Backend
+{
+  static constexpr bool Streams = true;
+
+  Backend()
+  {
+    if (::inflateInit(&stream) != Z_OK) {
+      throw std::runtime_error("zlib failed to init");
+    }
+  }
+
+  ~Backend() noexcept { ::inflateEnd(&stream); }
+
+  std::size_t inflate(std::string_view input, char* output, std::size_t size)
+  {
+    if (::inflateReset(&stream) != Z_OK) {
+      throw std::runtime_error("zlib failed to reset");
+    }
+
+    stream.next_in =
+        reinterpret_cast<z_const ::Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in  = static_cast<::uInt>(input.size());
+    stream.next_out  = reinterpret_cast<::Bytef*>(output);
+    stream.avail_out = static_cast<::uInt>(size);
+
+    if (::inflate(&stream, Z_FINISH) != Z_STREAM_END) {
+      throw std::runtime_error("zlib failed to read data");
+    }
+    return stream.total_out;
+  }
+
+  void begin(std::string_view input)
+  {
+    if (::inflateReset(&stream) != Z_OK) {
+      throw std::runtime_error("zlib failed to reset");
+    }
+
+    stream.next_in =
+        reinterpret_cast<z_const ::Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<::uInt>(input.size());
+  }
+
+  std::size_t resume(char* output, std::size_t size, bool& finished)
+  {
+    stream.next_out  = reinterpret_cast<::Bytef*>(output);
+    stream.avail_out = static_cast<::uInt>(size);
+
+    const int result = ::inflate(&stream, Z_NO_FLUSH);
+    if (result != Z_OK && result != Z_STREAM_END) {
+      throw std::runtime_error("zlib failed to read data");
+    }
+
+    finished = result == Z_STREAM_END;
+    return size - stream.avail_out;
+  }
+
+  // zeroed, which selects the default allocator and gives inflateInit no input
+  ::z_stream stream{};
+};
+
+#endif
+
+Inflater::Buffer::Buffer(Inflater* owner, std::unique_ptr<char[]> data,
+                         std::size_t capacity, std::size_t size)
+    : owner_{owner}, data_{std::move(data)}, capacity_{capacity}, size_{size}
+{}
+
+Inflater::Buffer::Buffer(Buffer&& other) noexcept
+    : owner_{std::exchange(other.owner_, nullptr)}, data_{std::move(other.data_)},
+      capacity_{std::exchange(other.capacity_, 0)},
+      size_{std::exchange(other.size_, 0)}
+{}
+
+Inflater::Buffer::~Buffer() noexcept
+{
+  release();
+}
+
+Inflater::Buffer& Inflater::Buffer::operator=(Buffer&& other) noexcept
+{
+  if (this != &other) {
+    release();
+    owner_    = std::exchange(other.owner_, nullptr);
+    data_     = std::move(other.data_);
+    capacity_ = std::exchange(other.capacity_, 0);
+    size_     = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+void Inflater::Buffer::release() noexcept
+{
+  if (owner_ && data_) {
+    owner_->recycle(std::move(data_), capacity_);
+  }
+  owner_    = nullptr;
+  capacity_ = 0;
+  size_     = 0;
+}
+
+Inflater::Inflater() : backend_{std::make_unique<Backend>()}
+{
+  pool_.reserve(MaxPooledBuffers);
+}
+
+Inflater::~Inflater() noexcept = default;
+
+Inflater& Inflater::local()
+{
+  thread_local Inflater inflater;
+  return inflater;
+}
+
+Inflater::Buffer Inflater::inflate(std::string_view input, std::uint32_t size)
+{
+  auto [data, capacity] = acquire(size);
+  if (size == 0) {
+    return Buffer(this, std::move(data), capacity, 0);
+  }
+
+  const std::size_t count = backend_->inflate(input, data.get(), size);
+  return Buffer(this, std::move(data), capacity, count);
+}
+
+Inflater::Stream Inflater::stream(std::string_view input, std::uint32_t size)
+{
+  backend_->begin(input);
+  auto [data, capacity] = acquire(size);
+  return Stream(this, Buffer(this, std::move(data), capacity, 0), size);
+}
+
+void Inflater::fill(Stream& stream, std::size_t size)
+{
+  Buffer& buffer = stream.buffer_;
+  while (!stream.finished_ && buffer.size_ < size) {
+    // overshoot small requests so that short subrecords don't each cost a call, and
+    // give a backend that cannot stream room for the whole record
+    const std::size_t end =
+        Backend::Streams
+            ? std::min(stream.limit_, std::max(size, buffer.size_ + StreamWindow))
+            : stream.limit_;
+
+    bool finished = false;
+    buffer.size_ += backend_->resume(buffer.data_.get() + buffer.size_,
+                                     end - buffer.size_, finished);
+    stream.finished_ = finished || buffer.size_ == stream.limit_;
+  }
+}
+
+Inflater::PooledBuffer Inflater::acquire(std::size_t size)
+{
+  const auto it = std::ranges::find_if(pool_, [&](auto&& buffer) {
+    return buffer.capacity >= size;
+  });
+
+  if (it != pool_.end()) {
+    PooledBuffer buffer = std::move(*it);
+    pool_.erase(it);
+    return buffer;
+  }
+
+  // round up so that slightly larger records can reuse the allocation
+  const std::size_t capacity = std::max<std::size_t>(std::bit_ceil(size), 0x1000);
+  return {std::make_unique_for_overwrite<char[]>(capacity), capacity};
+}
+
+void Inflater::recycle(std::unique_ptr<char[]> data, std::size_t capacity) noexcept
+{
+  if (pool_.size() < MaxPooledBuffers) {
+    pool_.push_back({std::move(data), capacity});
+  } else {
+    // keep the larger allocations around
+    const auto smallest = std::ranges::min_element(pool_, {}, &PooledBuffer::capacity);
+    if (smallest->capacity < capacity) {
+      *smallest = {std::move(data), capacity};
+    }
+  }
+}
+
+}  // namespace TESFile
@@ -0,0 +1,119 @@
+#ifndef TESFILE_INFLATER_H
+#define TESFILE_INFLATER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace TESFile
+{
+
+// Decompresses zlib-compressed record data. Each thread owns one inflater whose
+// decompression state is reset between records instead of being re-created, and whose
+// output buffers are recycled through a small pool.
+//
+// The implementation is chosen at build time: libdeflate when
+// TESFILE_INFLATE_LIBDEFLATE is defined, zlib otherwise.
+class Inflater final
+{
+public:
+  // Output buffer on loan from the inflater's pool, returned when destroyed
+  class Buffer final
+  {
+    friend class Inflater;
+
+  public:
+    Buffer() = default;
+    Buffer(Buffer&& other) noexcept;
+    ~Buffer() noexcept;
+
+    Buffer& operator=(Buffer&& other) noexcept;
+
+    [[nodiscard]] std::string_view view() const { return {data_.get(), size_}; }
+
+  private:
+    Buffer(Inflater* owner, std::unique_ptr<char[]> data, std::size_t capacity,
+           std::size_t size);
+
+    void release() noexcept;
+
+    Inflater* owner_ = nullptr;
+    std::unique_ptr<char[]> data_;
+    std::size_t capacity_ = 0;
+    std::size_t size_     = 0;
+  };
+
+  // Incremental decompression into a pooled buffer. Output is only produced as far as
+  // it has been requested, so the rest of a record can be skipped once the reader has
+  // what it needs. Only one stream may be in progress per inflater at a time.
+  class Stream final
+  {
+    friend class Inflater;
+
+  public:
+    [[nodiscard]] std::string_view view() const { return buffer_.view(); }
+    [[nodiscard]] bool finished() const { return finished_; }
+
+    // Inflates until at least `size` bytes are available or the stream has ended
+    void fill(std::size_t size) { owner_->fill(*this, size); }
+
+  private:
+    // a record that inflates to nothing has nothing to read, and inflating into an
+    // empty output would fail
+    Stream(Inflater* owner, Buffer buffer, std::size_t limit)
+        : owner_{owner}, buffer_{std::move(buffer)}, limit_{limit},
+          finished_{limit == 0}
+    {}
+
+    Inflater* owner_;
+    Buffer buffer_;
+    std::size_t limit_;
+    bool finished_ = false;
+  };
+
+  Inflater();
+
+  Inflater(const Inflater&) = delete;
+  Inflater(Inflater&&)      = delete;
+
+  ~Inflater() noexcept;
+
+  Inflater& operator=(const Inflater&) = delete;
+  Inflater& operator=(Inflater&&)      = delete;
+
+  [[nodiscard]] static Inflater& local();
+
+  // Inflates `input` into a buffer of at most `size` bytes. The returned view is
+  // shorter if the stream ends early.
+  [[nodiscard]] Buffer inflate(std::string_view input, std::uint32_t size);
+
+  // Begins inflating `input` into a buffer of at most `size` bytes, without producing
+  // any output yet. `input` must outlive the stream.
+  [[nodiscard]] Stream stream(std::string_view input, std::uint32_t size);
+
+private:
+  struct Backend;
+
+  struct PooledBuffer
+  {
+    std::unique_ptr<char[]> data;
+    std::size_t capacity;
+  };
+
+  static constexpr std::size_t MaxPooledBuffers = 4;
+  static constexpr std::size_t StreamWindow     = 0x200;
+
+  PooledBuffer acquire(std::size_t size);
+  void recycle(std::unique_ptr<char[]> data, std::size_t capacity) noexcept;
+  void fill(Stream& stream, std::size_t size);
+
+  std::unique_ptr<Backend> backend_;
+  std::vector<PooledBuffer> pool_;
+};
+
+}  // namespace TESFile
+
+#endif  // TESFILE_INFLATER_H
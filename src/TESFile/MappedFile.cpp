@@ -0,0 +1,71 @@
+#include "MappedFile.h"
+
+#include <Windows.h>
+
+#include <stdexcept>
+#include <system_error>
+
+namespace TESFile
+{
+
+static std::runtime_error lastError()
+{
+  return std::runtime_error(std::system_category().message(::GetLastError()));
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+  // share everything, like the stream reads this replaces, so that plugins can still
+  // be opened while an editor has them open for writing, and written or replaced by
+  // it while mapped
+  file_ = ::CreateFileW(path.c_str(), GENERIC_READ,
+                        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    file_ = nullptr;
+    throw lastError();
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!::GetFileSizeEx(file_, &fileSize)) {
+    const auto error = lastError();
+    ::CloseHandle(file_);
+    throw error;
+  }
+
+  size_ = static_cast<std::size_t>(fileSize.QuadPart);
+  if (size_ == 0) {
+    // empty files cannot be mapped
+    return;
+  }
+
+  mapping_ = ::CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_ == nullptr) {
+    const auto error = lastError();
+    ::CloseHandle(file_);
+    throw error;
+  }
+
+  data_ = static_cast<const char*>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    const auto error = lastError();
+    ::CloseHandle(mapping_);
+    ::CloseHandle(file_);
+    throw error;
+  }
+}
+
+MappedFile::~MappedFile() noexcept
+{
+  if (data_) {
+    ::UnmapViewOfFile(data_);
+  }
+  if (mapping_) {
+    ::CloseHandle(mapping_);
+  }
+  if (file_) {
+    ::CloseHandle(file_);
+  }
+}
+
+}  // namespace TESFile
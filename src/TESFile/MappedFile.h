@@ -0,0 +1,39 @@
+#ifndef TESFILE_MAPPEDFILE_H
+#define TESFILE_MAPPEDFILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace TESFile
+{
+
+// Read-only view of an entire file mapped into the address space. Pages are only
+// faulted in when touched, so skipped regions of a plugin cost no I/O.
+class MappedFile final
+{
+public:
+  explicit MappedFile(const std::filesystem::path& path);
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&&)      = delete;
+
+  ~MappedFile() noexcept;
+
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&&)      = delete;
+
+  [[nodiscard]] const char* data() const { return data_; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] std::string_view view() const { return {data_, size_}; }
+
+private:
+  void* file_       = nullptr;
+  void* mapping_    = nullptr;
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace TESFile
+
+#endif  // TESFILE_MAPPEDFILE_H
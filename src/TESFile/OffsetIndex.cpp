@@ -0,0 +1,122 @@
+#include "OffsetIndex.h"
+
+#include <algorithm>
+#include <system_error>
+
+namespace TESFile
+{
+
+void OffsetIndex::clear()
+{
+  groups_.clear();
+  groupLookup_.clear();
+  forms_.clear();
+  fileSize_      = 0;
+  lastWriteTime_ = {};
+}
+
+std::uint32_t OffsetIndex::addGroup(GroupData group, std::uint32_t offset,
+                                    std::uint32_t parent)
+{
+  const auto index = static_cast<std::uint32_t>(groups_.size());
+  groups_.push_back({group, offset, parent});
+  return index;
+}
+
+void OffsetIndex::addForm(Type type, std::uint32_t formId, std::uint32_t offset,
+                          std::uint32_t group)
+{
+  forms_.push_back({formId, type, offset, group});
+}
+
+void OffsetIndex::append(const OffsetIndex& other)
+{
+  const auto base  = static_cast<std::uint32_t>(groups_.size());
+  const auto remap = [base](std::uint32_t group) {
+    return group != NoGroup ? group + base : NoGroup;
+  };
+
+  groups_.reserve(groups_.size() + other.groups_.size());
+  for (const auto& entry : other.groups_) {
+    groups_.push_back({entry.group, entry.offset, remap(entry.parent)});
+  }
+
+  forms_.reserve(forms_.size() + other.forms_.size());
+  for (const auto& entry : other.forms_) {
+    forms_.push_back({entry.formId, entry.type, entry.offset, remap(entry.group)});
+  }
+}
+
+void OffsetIndex::finalize()
+{
+  groupLookup_.clear();
+  for (std::uint32_t i = 0; i < groups_.size(); ++i) {
+    const auto& group = groups_[i].group;
+    if (group.hasFormType() || group.hasParent()) {
+      groupLookup_.push_back(i);
+    }
+  }
+
+  // stable so that the first occurrence wins if a file repeats a key
+  std::ranges::stable_sort(groupLookup_, {}, [&](std::uint32_t i) {
+    return groups_[i].group;
+  });
+  std::ranges::stable_sort(forms_, {}, &FormEntry::formId);
+}
+
+void OffsetIndex::stamp(const std::filesystem::path& path)
+{
+  std::error_code ec;
+  fileSize_      = std::filesystem::file_size(path, ec);
+  lastWriteTime_ = std::filesystem::last_write_time(path, ec);
+}
+
+bool OffsetIndex::isCurrent(const std::filesystem::path& path) const
+{
+  std::error_code ec;
+  const auto fileSize = std::filesystem::file_size(path, ec);
+  if (ec || fileSize != fileSize_) {
+    return false;
+  }
+
+  const auto lastWriteTime = std::filesystem::last_write_time(path, ec);
+  return !ec && lastWriteTime == lastWriteTime_;
+}
+
+std::optional<OffsetIndex::Location> OffsetIndex::findGroup(GroupData group) const
+{
+  const auto it = std::ranges::lower_bound(groupLookup_, group, {}, [&](std::uint32_t i) {
+    return groups_[i].group;
+  });
+
+  if (it == groupLookup_.end() || groups_[*it].group != group) {
+    return std::nullopt;
+  }
+
+  const auto& entry = groups_[*it];
+  Location location{entry.offset, "GRUP"_ts, entry.group.parent(), {}};
+  addAncestors(location, entry.parent);
+  return location;
+}
+
+std::optional<OffsetIndex::Location> OffsetIndex::findForm(std::uint32_t formId) const
+{
+  const auto it = std::ranges::lower_bound(forms_, formId, {}, &FormEntry::formId);
+  if (it == forms_.end() || it->formId != formId) {
+    return std::nullopt;
+  }
+
+  Location location{it->offset, it->type, it->formId, {}};
+  addAncestors(location, it->group);
+  return location;
+}
+
+void OffsetIndex::addAncestors(Location& location, std::uint32_t group) const
+{
+  for (; group != NoGroup; group = groups_[group].parent) {
+    location.ancestors.push_back(groups_[group].group);
+  }
+  std::ranges::reverse(location.ancestors);
+}
+
+}  // namespace TESFile
@@ -0,0 +1,85 @@
+#ifndef TESFILE_OFFSETINDEX_H
+#define TESFILE_OFFSETINDEX_H
+
+#include "Stream.h"
+
+#include <boost/container/small_vector.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace TESFile
+{
+
+// File offsets of the groups and records seen while reading a plugin, so that a later
+// read can start at a particular group or record instead of at the beginning.
+//
+// Every group the reader passes is recorded, including those the handler skipped, but
+// only records inside groups the handler descended into. Groups can only be looked up
+// if they are identified uniquely, i.e. top groups and groups with a parent record.
+class OffsetIndex final
+{
+public:
+  static constexpr std::uint32_t NoGroup = 0xFFFFFFFF;
+
+  // Where to resume reading, and the groups enclosing that point, outermost first
+  struct Location
+  {
+    std::uint32_t offset;
+    Type type;
+    std::uint32_t id;
+    boost::container::small_vector<GroupData, 4> ancestors;
+  };
+
+  void clear();
+
+  std::uint32_t addGroup(GroupData group, std::uint32_t offset, std::uint32_t parent);
+  void addForm(Type type, std::uint32_t formId, std::uint32_t offset,
+               std::uint32_t group);
+
+  // Adds the entries of an index built from a later part of the same file
+  void append(const OffsetIndex& other);
+
+  // Prepares the index for lookups once reading is complete
+  void finalize();
+
+  // Records the size and modification time of the file the index describes
+  void stamp(const std::filesystem::path& path);
+
+  // Checks whether the file is unchanged since the index was stamped
+  [[nodiscard]] bool isCurrent(const std::filesystem::path& path) const;
+
+  [[nodiscard]] std::optional<Location> findGroup(GroupData group) const;
+  [[nodiscard]] std::optional<Location> findForm(std::uint32_t formId) const;
+
+private:
+  struct GroupEntry
+  {
+    GroupData group;
+    std::uint32_t offset;
+    std::uint32_t parent;
+  };
+
+  struct FormEntry
+  {
+    std::uint32_t formId;
+    Type type;
+    std::uint32_t offset;
+    std::uint32_t group;
+  };
+
+  void addAncestors(Location& location, std::uint32_t group) const;
+
+  std::vector<GroupEntry> groups_;
+  std::vector<std::uint32_t> groupLookup_;
+  std::vector<FormEntry> forms_;
+
+  std::uintmax_t fileSize_ = 0;
+  std::filesystem::file_time_type lastWriteTime_;
+};
+
+}  // namespace TESFile
+
+#endif  // TESFILE_OFFSETINDEX_H
@@ -1,42 +1,125 @@
 #ifndef TESFILE_READER_H
 #define TESFILE_READER_H
 
+#include "Cursor.h"
+#include "Inflater.h"
+#include "OffsetIndex.h"
+#include "ReaderStats.h"
 #include "Stream.h"
+#include "TypeSet.h"
 
+#include <chrono>
 #include <concepts>
 #include <cstdint>
 #include <filesystem>
 #include <istream>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 namespace TESFile
 {
 
+// Group, Form and Chunk may return a Traversal, or a bool meaning Descend or Skip
+template <typename T>
+concept TraversalResult = std::same_as<T, Traversal> || std::convertible_to<T, bool>;
+
+// Handlers receive subrecord data either as a Cursor over the raw bytes or, for
+// compatibility, as a std::istream.
+template <typename Handler>
+concept CursorDataHandler = requires(Handler& handler) {
+  {
+    handler.Data(std::declval<Cursor&>())
+  };
+};
+
+template <typename Handler>
+concept StreamDataHandler = requires(Handler& handler) {
+  {
+    handler.Data(std::declval<std::istream&>())
+  };
+};
+
+// Handlers may report that they have everything they need from the current form, in
+// which case its remaining subrecords are skipped and compressed data is inflated only
+// as far as has been read. EndForm is still called. The check is made after every
+// subrecord, including those the handler was not asked about.
+template <typename Handler>
+concept FormCompletionHandler = requires(Handler& handler) {
+  {
+    handler.FormComplete()
+  } -> std::convertible_to<bool>;
+};
+
+// Handlers may declare the elements they are interested in up front, as any of
+//   static constexpr TypeSet WantedForms{...};   // record types
+//   static constexpr TypeSet WantedGroups{...};  // GroupType values
+//   static constexpr TypeSet WantedChunks{...};  // subrecord types
+// Elements not in a declared set are skipped without calling the handler. The plugin
+// info record is always read.
 template <typename Handler>
 concept ReaderHandler = requires(Handler& handler) {
   {
     handler.Group(std::declval<GroupData>())
-  } -> std::convertible_to<bool>;
+  } -> TraversalResult;
   {
     handler.Form(std::declval<FormData>())
-  } -> std::convertible_to<bool>;
+  } -> TraversalResult;
   {
     handler.Chunk(std::declval<Type>())
-  } -> std::convertible_to<bool>;
-  {
-    handler.Data(std::declval<std::istream&>())
-  };
-};
+  } -> TraversalResult;
+} && (CursorDataHandler<Handler> || StreamDataHandler<Handler>);
 
 template <ReaderHandler Handler>
 class Reader
 {
 public:
-  void parse(const std::filesystem::path& path, Handler& handler);
+  // Counters from every following parse are added to `stats`, if not null
+  void setStats(ReaderStats* stats) { stats_ = stats; }
+
+  // Maps the file into memory and parses it in place
+  void parse(const std::filesystem::path& path, Handler& handler,
+             OffsetIndex* index = nullptr);
 
   void parse(std::istream& stream, Handler& handler);
 
+  // Parses a complete plugin image. Uncompressed subrecord data is handed to the
+  // handler as a view into `data`, which must outlive the call. If `index` is given,
+  // it is rebuilt with the offsets of the elements passed along the way.
+  //
+  // When the handler returns Traversal::Stop, no further elements are visited, but
+  // EndForm and EndGroup are still called for the elements it is inside of.
+  void parse(std::string_view data, Handler& handler, OffsetIndex* index = nullptr);
+
+  // Parses the plugin info and then only the group or record at `location`. The
+  // handler first receives the groups enclosing it, as it would in a complete parse.
+  void parse(const std::filesystem::path& path, const OffsetIndex::Location& location,
+             Handler& handler);
+
+  void parse(std::string_view data, const OffsetIndex::Location& location,
+             Handler& handler);
+
+  // Smallest amount of data worth handing to another thread. Files smaller than twice
+  // this are read on the calling thread only.
+  static constexpr std::size_t ConcurrentGranularity = 0x2000000;
+
+  // Parses a complete plugin, splitting the top groups into runs that are read on up
+  // to `maxThreads` threads at once, one of them the calling thread. Each run gets
+  // its own copy of the handler, made after the plugin info has been read.
+  // Afterwards the copies are passed in file order to handler.Merge, if there is one.
+  // Traversal::Stop only ends the run it was returned in. Files too small to be worth
+  // splitting are read on this thread.
+  void parseConcurrently(const std::filesystem::path& path, Handler& handler,
+                         unsigned int maxThreads, OffsetIndex* index = nullptr)
+    requires std::copy_constructible<Handler>;
+
+  void parseConcurrently(std::string_view data, Handler& handler,
+                         unsigned int maxThreads, OffsetIndex* index = nullptr)
+    requires std::copy_constructible<Handler>;
+
 private:
+  using Clock = std::chrono::steady_clock;
+
   enum HeaderSize
   {
     HeaderSize_Standard  = sizeof(RecordHeader),
@@ -44,20 +127,59 @@ private:
     HeaderSize_Morrowind = 16,
   };
 
-  std::uint32_t parsePluginInfo(std::istream& stream, Handler& handler);
+  // Each of these takes a view starting at the element to be parsed and returns the
+  // number of bytes it occupies.
+
+  std::uint32_t parsePluginInfo(std::string_view data, Handler& handler);
+
+  // Parses the top level records from `begin` up to `end`
+  void parseRange(std::size_t begin, std::size_t end, Handler& handler);
+
+  // Splits the top level records from `begin` to the end of the data into at most
+  // `count` runs of similar size
+  std::vector<std::pair<std::size_t, std::size_t>> partition(std::size_t begin,
+                                                             unsigned int count) const;
 
-  std::uint32_t parseRecord(std::istream& stream, Handler& handler);
+  std::uint32_t parseRecord(std::string_view data, Handler& handler);
 
-  std::uint32_t handleForm(std::istream& stream, const RecordHeader& header,
+  std::uint32_t handleForm(std::string_view data, const RecordHeader& header,
                            Handler& handler);
 
-  std::uint32_t handleGroup(std::istream& stream, const RecordHeader& header,
+  std::uint32_t handleGroup(std::string_view data, const RecordHeader& header,
                             Handler& handler);
 
-  std::uint32_t parseChunk(std::istream& stream, Handler& handler);
+  void parseChunks(std::string_view data, Handler& handler);
+
+  void parseChunks(Inflater::Stream& stream, Handler& handler);
+
+  std::uint32_t parseChunk(std::string_view data, Handler& handler);
+
+  // Returns the size of the chunk at the start of `data`, or the size of its header if
+  // that is not yet complete
+  static std::uint32_t chunkExtent(std::string_view data);
+
+  bool formComplete(Handler& handler);
+
+  static constexpr bool wantsForm(Type type);
+  static constexpr bool wantsGroup(GroupType type);
+  static constexpr bool wantsChunk(Type type);
+
+  // Returns the position of `data` within the plugin image being parsed
+  std::uint32_t offsetOf(std::string_view data) const;
+
+  void countError();
+
+  // Interprets a handler result, recording whether it asked to stop
+  Traversal visit(TraversalResult auto result);
 
   TESFormat chunkFormat_;
   int headerSize_;
+  bool stopped_ = false;
+
+  std::string_view data_;
+  OffsetIndex* index_         = nullptr;
+  std::uint32_t currentGroup_ = OffsetIndex::NoGroup;
+  ReaderStats* stats_         = nullptr;
 };
 
 }  // namespace TESFile
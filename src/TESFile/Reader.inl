@@ -1,49 +1,288 @@
+#include "MappedFile.h"
 #include "Reader.h"
 
 #include <fmt/format.h>
-#include <zlib.h>
 
+#include <algorithm>
 #include <cstring>
-#include <fstream>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <span>
 #include <stdexcept>
 
 namespace TESFile
 {
 
 template <ReaderHandler Handler>
-inline void Reader<Handler>::parse(const std::filesystem::path& path, Handler& handler)
+inline void Reader<Handler>::parse(const std::filesystem::path& path, Handler& handler,
+                                   OffsetIndex* index)
 {
-  std::ifstream stream;
-  stream.open(path, std::ios_base::binary | std::ios_base::in);
-  if (!stream.good()) {
-    throw std::runtime_error(std::strerror(errno));
+  const MappedFile file{path};
+  parse(file.view(), handler, index);
+
+  if (index) {
+    index->stamp(path);
   }
-  parse(stream, handler);
 }
 
 template <ReaderHandler Handler>
 inline void Reader<Handler>::parse(std::istream& stream, Handler& handler)
 {
-  parsePluginInfo(stream, handler);
-  while (stream.good() && stream.peek() != std::char_traits<char>::eof()) {
-    parseRecord(stream, handler);
+  const std::string data{std::istreambuf_iterator<char>(stream),
+                         std::istreambuf_iterator<char>()};
+  parse(std::string_view(data), handler);
+}
+
+template <ReaderHandler Handler>
+inline void Reader<Handler>::parse(std::string_view data, Handler& handler,
+                                   OffsetIndex* index)
+try {
+  stopped_      = false;
+  data_         = data;
+  index_        = index;
+  currentGroup_ = OffsetIndex::NoGroup;
+
+  if (index_) {
+    index_->clear();
+  }
+
+  parseRange(parsePluginInfo(data, handler), data.size(), handler);
+
+  if (index_) {
+    index_->finalize();
+    index_ = nullptr;
   }
+} catch (...) {
+  countError();
+  throw;
 }
 
 template <ReaderHandler Handler>
-inline std::uint32_t Reader<Handler>::parsePluginInfo(std::istream& stream,
+inline void Reader<Handler>::parse(const std::filesystem::path& path,
+                                   const OffsetIndex::Location& location,
+                                   Handler& handler)
+{
+  const MappedFile file{path};
+  parse(file.view(), location, handler);
+}
+
+template <ReaderHandler Handler>
+inline void Reader<Handler>::parse(std::string_view data,
+                                   const OffsetIndex::Location& location,
+                                   Handler& handler)
+try {
+  stopped_      = false;
+  data_         = data;
+  index_        = nullptr;
+  currentGroup_ = OffsetIndex::NoGroup;
+
+  parsePluginInfo(data, handler);
+
+  if (location.offset > data.size() ||
+      data.size() - location.offset < static_cast<std::size_t>(headerSize_)) {
+    throw std::runtime_error("indexed offset is out of range");
+  }
+
+  RecordHeader header;
+  std::memcpy(&header, data.data() + location.offset, headerSize_);
+  const std::uint32_t id = header.type == "GRUP"_ts ? header.groupData.label
+                                                    : header.formData.formId;
+  if (header.type != location.type || id != location.id) {
+    throw std::runtime_error("offset index does not match file");
+  }
+
+  std::size_t entered = 0;
+  for (const auto& group : location.ancestors) {
+    if (stopped_ || visit(handler.Group(group)) != Traversal::Descend) {
+      break;
+    }
+    ++entered;
+  }
+
+  if (entered == location.ancestors.size() && !stopped_) {
+    parseRecord(data.substr(location.offset), handler);
+  }
+
+  if constexpr (requires { handler.EndGroup(); }) {
+    for (; entered != 0; --entered) {
+      handler.EndGroup();
+    }
+  }
+} catch (...) {
+  countError();
+  throw;
+}
+
+template <ReaderHandler Handler>
+inline void Reader<Handler>::parseConcurrently(const std::filesystem::path& path,
+                                               Handler& handler,
+                                               unsigned int maxThreads,
+                                               OffsetIndex* index)
+  requires std::copy_constructible<Handler>
+{
+  const MappedFile file{path};
+  parseConcurrently(file.view(), handler, maxThreads, index);
+
+  if (index) {
+    index->stamp(path);
+  }
+}
+
+template <ReaderHandler Handler>
+inline void Reader<Handler>::parseConcurrently(std::string_view data, Handler& handler,
+                                               unsigned int maxThreads,
+                                               OffsetIndex* index)
+  requires std::copy_constructible<Handler>
+try {
+  stopped_      = false;
+  data_         = data;
+  index_        = index;
+  currentGroup_ = OffsetIndex::NoGroup;
+
+  if (index_) {
+    index_->clear();
+  }
+
+  const std::size_t begin = parsePluginInfo(data, handler);
+  const auto ranges       = partition(begin, maxThreads);
+
+  if (ranges.size() <= 1) {
+    parseRange(begin, data.size(), handler);
+  } else {
+    std::vector<Handler> handlers(ranges.size(), handler);
+    std::vector<OffsetIndex> indices(index_ ? ranges.size() : 0);
+    std::vector<ReaderStats> stats(stats_ ? ranges.size() : 0);
+
+    const auto makeWorker = [&](std::size_t i) {
+      Reader worker = *this;
+      worker.index_ = indices.empty() ? nullptr : &indices[i];
+      worker.stats_ = stats.empty() ? nullptr : &stats[i];
+      return worker;
+    };
+
+    // the first run is read on this thread, so that it counts towards maxThreads
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(ranges.size() - 1);
+    for (std::size_t i = 1; i < ranges.size(); ++i) {
+      tasks.push_back(
+          std::async(std::launch::async, [&, i, worker = makeWorker(i)]() mutable {
+            worker.parseRange(ranges[i].first, ranges[i].second, handlers[i]);
+          }));
+    }
+
+    std::exception_ptr error;
+    try {
+      makeWorker(0).parseRange(ranges[0].first, ranges[0].second, handlers[0]);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    // the workers refer to the data, so let them all finish before reporting errors
+    for (auto& task : tasks) {
+      task.wait();
+    }
+    for (const auto& workerStats : stats) {
+      *stats_ += workerStats;
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    for (auto& task : tasks) {
+      task.get();
+    }
+
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+      if constexpr (requires { handler.Merge(std::move(handlers[i])); }) {
+        handler.Merge(std::move(handlers[i]));
+      }
+      if (index_) {
+        index_->append(indices[i]);
+      }
+    }
+  }
+
+  if (index_) {
+    index_->finalize();
+    index_ = nullptr;
+  }
+} catch (...) {
+  countError();
+  throw;
+}
+
+template <ReaderHandler Handler>
+inline void Reader<Handler>::parseRange(std::size_t begin, std::size_t end,
+                                        Handler& handler)
+{
+  std::size_t offset = begin;
+  while (offset < end && !stopped_) {
+    offset += parseRecord(data_.substr(offset, end - offset), handler);
+  }
+}
+
+template <ReaderHandler Handler>
+inline std::vector<std::pair<std::size_t, std::size_t>>
+Reader<Handler>::partition(std::size_t begin, unsigned int count) const
+{
+  const std::size_t total = data_.size() - begin;
+  const std::size_t parts =
+      std::clamp<std::size_t>(total / ConcurrentGranularity, 1, std::max(count, 1U));
+  const std::size_t target = total / parts;
+
+  std::vector<std::pair<std::size_t, std::size_t>> ranges;
+  if (parts == 1) {
+    ranges.emplace_back(begin, data_.size());
+    return ranges;
+  }
+
+  // only the headers are read here; everything else is checked when parsed
+  std::size_t start  = begin;
+  std::size_t offset = begin;
+  while (offset < data_.size()) {
+    if (data_.size() - offset < static_cast<std::size_t>(headerSize_)) {
+      throw std::runtime_error("record incomplete");
+    }
+
+    RecordHeader header;
+    std::memcpy(&header, data_.data() + offset, headerSize_);
+
+    const std::size_t size =
+        header.type == "GRUP"_ts ? header.dataSize : headerSize_ + header.dataSize;
+    if (size < static_cast<std::size_t>(headerSize_) || size > data_.size() - offset) {
+      throw std::runtime_error(header.type == "GRUP"_ts ? "group incomplete"
+                                                        : "record incomplete");
+    }
+
+    offset += size;
+    if (offset - start >= target && ranges.size() + 1 < parts) {
+      ranges.emplace_back(start, offset);
+      start = offset;
+    }
+  }
+
+  if (start < data_.size()) {
+    ranges.emplace_back(start, data_.size());
+  }
+
+  return ranges;
+}
+
+template <ReaderHandler Handler>
+inline std::uint32_t Reader<Handler>::parsePluginInfo(std::string_view data,
                                                       Handler& handler)
 {
-  const RecordHeader header = readType<RecordHeader>(stream);
-  if (stream.fail()) {
+  if (data.size() < sizeof(RecordHeader)) {
     throw std::runtime_error("record incomplete");
   }
 
+  RecordHeader header;
+  std::memcpy(&header, data.data(), sizeof(RecordHeader));
+
   if (header.type == "TES4"_ts) {
     if (header.old.firstChunk == "HEDR"_ts) {
       chunkFormat_ = TESFormat::Oblivion;
       headerSize_  = HeaderSize_Oblivion;
-      stream.seekg(HeaderSize_Oblivion - sizeof(RecordHeader), std::istream::cur);
     } else {
       chunkFormat_ = TESFormat::Standard;
       headerSize_  = sizeof(RecordHeader);
@@ -51,121 +290,139 @@ inline std::uint32_t Reader<Handler>::parsePluginInfo(std::istream& stream,
   } else if (header.type == "TES3"_ts) {
     chunkFormat_ = TESFormat::Morrowind;
     headerSize_  = HeaderSize_Morrowind;
-    stream.seekg(HeaderSize_Morrowind - sizeof(RecordHeader), std::istream::cur);
   } else {
     throw std::runtime_error(
         fmt::format("Unrecognized plugin info type: '{}'", header.type.value));
   }
 
-  return handleForm(stream, header, handler);
+  return handleForm(data, header, handler);
 }
 
 template <ReaderHandler Handler>
-inline std::uint32_t Reader<Handler>::parseRecord(std::istream& stream,
+inline std::uint32_t Reader<Handler>::parseRecord(std::string_view data,
                                                   Handler& handler)
 {
-  RecordHeader header;
-  stream.read(reinterpret_cast<char*>(&header), headerSize_);
-  if (stream.fail()) {
+  if (data.size() < static_cast<std::size_t>(headerSize_)) {
     throw std::runtime_error("record incomplete");
   }
 
+  RecordHeader header;
+  std::memcpy(&header, data.data(), headerSize_);
+
   if (header.type == "GRUP"_ts) {
-    return handleGroup(stream, header, handler);
+    return handleGroup(data, header, handler);
   } else {
-    return handleForm(stream, header, handler);
+    return handleForm(data, header, handler);
   }
 }
 
 template <ReaderHandler Handler>
-inline std::uint32_t Reader<Handler>::handleForm(std::istream& stream,
+inline std::uint32_t Reader<Handler>::handleForm(std::string_view data,
                                                  const RecordHeader& header,
                                                  Handler& handler)
 {
-  std::uint32_t dataSize = header.dataSize;
-  const bool compressed  = header.formData.flags & RecordFlags::Compressed;
-  if (handler.Form(
-          FormData(header.type, header.formData.flags, header.formData.formId))) {
+  if (data.size() - headerSize_ < header.dataSize) {
+    throw std::runtime_error("record incomplete");
+  }
 
-    std::string data;
-    data.resize(dataSize);
-    stream.read(data.data(), dataSize);
-    if (stream.fail()) {
-      throw std::runtime_error("chunk incomplete");
-    }
+  if (index_ && currentGroup_ != OffsetIndex::NoGroup) {
+    index_->addForm(header.type, header.formData.formId, offsetOf(data), currentGroup_);
+  }
+
+  const bool wanted = header.type == "TES4"_ts || header.type == "TES3"_ts ||
+                     wantsForm(header.type);
 
-    std::istringstream chunkstream;
-    if (!compressed) {
-      chunkstream.str(std::move(data));
+  std::string_view payload = data.substr(headerSize_, header.dataSize);
+  const bool compressed    = header.formData.flags & RecordFlags::Compressed;
+  const FormData form{header.type, header.formData.flags, header.formData.formId};
+  const bool accepted = wanted && visit(handler.Form(form)) == Traversal::Descend;
+
+  if (stats_) {
+    auto& counts = stats_->forms[header.type];
+    ++counts.visited;
+    if (accepted) {
+      ++counts.accepted;
+      stats_->bytesRead += headerSize_ + header.dataSize;
     } else {
-      if (data.size() < 4) {
-        throw std::runtime_error("chunk incomplete");
-      }
+      stats_->bytesSkipped += headerSize_ + header.dataSize;
+    }
+  }
 
-      std::memcpy(&dataSize, data.data(), sizeof(dataSize));
-
-      std::string inflated;
-      inflated.resize(dataSize);
-
-      int zret;
-      ::z_stream zstreambuf{
-          .next_in = reinterpret_cast<z_const ::Bytef*>(data.data() + sizeof(dataSize)),
-          .avail_in  = static_cast<::uInt>(data.size() - sizeof(dataSize)),
-          .next_out  = reinterpret_cast<::Bytef*>(inflated.data()),
-          .avail_out = static_cast<::uInt>(inflated.size()),
-          .zalloc    = Z_NULL,
-          .zfree     = Z_NULL,
-          .opaque    = Z_NULL,
-      };
-      zret = ::inflateInit(&zstreambuf);
-      if (zret != Z_OK) {
-        throw std::runtime_error("zlib failed to init");
-      }
+  if (accepted) {
 
-      zret = ::inflate(&zstreambuf, Z_FINISH);
-      if (zret != Z_STREAM_END) {
-        throw std::runtime_error("zlib failed to read data");
+    if (compressed) {
+      if (payload.size() < 4) {
+        throw std::runtime_error("chunk incomplete");
       }
-      zret = ::inflateEnd(&zstreambuf);
-
-      chunkstream.str(std::move(inflated));
-    }
 
-    while (dataSize != 0) {
-      const std::uint32_t fieldSize = parseChunk(chunkstream, handler);
+      std::uint32_t inflatedSize;
+      std::memcpy(&inflatedSize, payload.data(), sizeof(inflatedSize));
+      payload = payload.substr(sizeof(inflatedSize));
 
-      if (fieldSize > dataSize) {
-        throw std::runtime_error(
-            fmt::format("Subrecord exceeded record size ({}-{})", dataSize, fieldSize));
+      if (stats_) {
+        stats_->compressedBytes += payload.size();
       }
 
-      dataSize -= fieldSize;
+      if constexpr (FormCompletionHandler<Handler>) {
+        auto stream = Inflater::local().stream(payload, inflatedSize);
+        parseChunks(stream, handler);
+      } else {
+        const auto start    = stats_ ? Clock::now() : Clock::time_point();
+        const auto inflated = Inflater::local().inflate(payload, inflatedSize);
+        if (stats_) {
+          stats_->inflateTime += Clock::now() - start;
+          stats_->inflatedBytes += inflated.view().size();
+        }
+
+        parseChunks(inflated.view(), handler);
+      }
+    } else {
+      parseChunks(payload, handler);
     }
 
     if constexpr (requires { handler.EndForm(); }) {
       handler.EndForm();
     }
-  } else {
-    stream.seekg(dataSize, std::istream::cur);
-    if (stream.fail()) {
-      throw std::runtime_error("record incomplete");
-    }
   }
 
   return headerSize_ + header.dataSize;
 }
 
 template <ReaderHandler Handler>
-inline std::uint32_t Reader<Handler>::handleGroup(std::istream& stream,
+inline std::uint32_t Reader<Handler>::handleGroup(std::string_view data,
                                                   const RecordHeader& header,
                                                   Handler& handler)
 {
-  std::uint32_t dataSize = header.dataSize - headerSize_;
+  if (header.dataSize < static_cast<std::uint32_t>(headerSize_) ||
+      data.size() < header.dataSize) {
+    throw std::runtime_error("group incomplete");
+  }
+
+  const GroupData group{header.groupData.label, header.groupData.groupType};
+  const std::uint32_t parentGroup = currentGroup_;
+  if (index_) {
+    currentGroup_ = index_->addGroup(group, offsetOf(data), parentGroup);
+  }
+
+  const bool accepted =
+      wantsGroup(group.type()) && visit(handler.Group(group)) == Traversal::Descend;
+
+  if (stats_) {
+    ++stats_->groupsVisited;
+    if (accepted) {
+      ++stats_->groupsAccepted;
+      stats_->bytesRead += headerSize_;
+    } else {
+      stats_->bytesSkipped += header.dataSize;
+    }
+  }
 
-  if (handler.Group(GroupData(header.groupData.label, header.groupData.groupType))) {
+  if (accepted) {
 
-    while (dataSize != 0) {
-      const std::uint32_t recordSize = parseRecord(stream, handler);
+    std::uint32_t dataSize = header.dataSize - headerSize_;
+    while (dataSize != 0 && !stopped_) {
+      const std::uint32_t recordSize =
+          parseRecord(data.substr(header.dataSize - dataSize), handler);
 
       if (recordSize > dataSize) {
         throw std::runtime_error(
@@ -178,56 +435,202 @@ inline std::uint32_t Reader<Handler>::handleGroup(std::istream& stream,
     if constexpr (requires { handler.EndGroup(); }) {
       handler.EndGroup();
     }
-  } else {
-    stream.seekg(dataSize, std::istream::cur);
-    if (stream.fail()) {
-      throw std::runtime_error("group incomplete");
-    }
   }
 
+  currentGroup_ = parentGroup;
   return header.dataSize;
 }
 
 template <ReaderHandler Handler>
-inline std::uint32_t Reader<Handler>::parseChunk(std::istream& stream, Handler& handler)
+inline void Reader<Handler>::parseChunks(std::string_view data, Handler& handler)
+{
+  std::uint32_t dataSize = static_cast<std::uint32_t>(data.size());
+  while (dataSize != 0) {
+    const std::uint32_t fieldSize =
+        parseChunk(data.substr(data.size() - dataSize), handler);
+
+    if (fieldSize > dataSize) {
+      throw std::runtime_error(
+          fmt::format("Subrecord exceeded record size ({}-{})", dataSize, fieldSize));
+    }
+
+    dataSize -= fieldSize;
+
+    if (stopped_ || formComplete(handler)) {
+      break;
+    }
+  }
+}
+
+template <ReaderHandler Handler>
+inline void Reader<Handler>::parseChunks(Inflater::Stream& stream, Handler& handler)
+{
+  std::size_t offset = 0;
+  for (;;) {
+    std::size_t required = offset + chunkExtent(stream.view().substr(offset));
+    while (stream.view().size() < required && !stream.finished()) {
+      const auto start = stats_ ? Clock::now() : Clock::time_point();
+      stream.fill(required);
+      if (stats_) {
+        stats_->inflateTime += Clock::now() - start;
+      }
+
+      required = offset + chunkExtent(stream.view().substr(offset));
+    }
+
+    if (offset == stream.view().size()) {
+      break;
+    }
+
+    offset += parseChunk(stream.view().substr(offset), handler);
+
+    if (stopped_ || formComplete(handler)) {
+      break;
+    }
+  }
+
+  if (stats_) {
+    stats_->inflatedBytes += stream.view().size();
+  }
+}
+
+template <ReaderHandler Handler>
+inline std::uint32_t Reader<Handler>::parseChunk(std::string_view data, Handler& handler)
 {
-  ChunkHeader header = readType<ChunkHeader>(stream);
-  if (stream.fail()) {
+  if (data.size() < sizeof(ChunkHeader)) {
     throw std::runtime_error("chunk header incomplete");
   }
-  std::uint32_t readSize = sizeof(ChunkHeader) + header.dataSize;
+
+  ChunkHeader header;
+  std::memcpy(&header, data.data(), sizeof(ChunkHeader));
+  std::uint32_t readSize = sizeof(ChunkHeader);
 
   std::uint32_t dataSize = header.dataSize;
   if (header.type == "XXXX"_ts) {
     if (dataSize != 4) {
       throw std::runtime_error("XXXX field has invalid size");
     }
-    dataSize = readType<std::uint32_t>(stream);
-    header   = readType<ChunkHeader>(stream);
-    if (stream.fail()) {
+    if (data.size() < 2 * sizeof(ChunkHeader) + sizeof(std::uint32_t)) {
       throw std::runtime_error("chunk size incomplete");
     }
-    readSize += sizeof(ChunkHeader) + dataSize;
+    std::memcpy(&dataSize, data.data() + readSize, sizeof(dataSize));
+    readSize += sizeof(dataSize);
+    std::memcpy(&header, data.data() + readSize, sizeof(ChunkHeader));
+    readSize += sizeof(ChunkHeader);
+  }
+
+  if (data.size() - readSize < dataSize) {
+    throw std::runtime_error("chunk data incomplete");
   }
 
-  if (handler.Chunk(header.type)) {
-    std::string field;
-    field.resize(dataSize);
-    stream.read(field.data(), dataSize);
-    if (stream.fail()) {
-      throw std::runtime_error("chunk data incomplete");
+  if (wantsChunk(header.type) &&
+      visit(handler.Chunk(header.type)) == Traversal::Descend) {
+    const auto field = data.substr(readSize, dataSize);
+    if (stats_) {
+      ++stats_->chunksDelivered;
     }
-    std::istringstream data(std::move(field));
-    data.exceptions(std::ios_base::failbit);
-    handler.Data(data);
-  } else {
-    stream.seekg(dataSize, std::istream::cur);
-    if (stream.fail()) {
-      throw std::runtime_error("chunk incomplete");
+    if constexpr (CursorDataHandler<Handler>) {
+      Cursor cursor{std::as_bytes(std::span(field))};
+      handler.Data(cursor);
+    } else {
+      ViewStreamBuf buffer{field};
+      std::istream stream{&buffer};
+      stream.exceptions(std::ios_base::failbit);
+      handler.Data(stream);
+    }
+  }
+
+  return readSize + dataSize;
+}
+
+template <ReaderHandler Handler>
+inline std::uint32_t Reader<Handler>::chunkExtent(std::string_view data)
+{
+  if (data.size() < sizeof(ChunkHeader)) {
+    return sizeof(ChunkHeader);
+  }
+
+  ChunkHeader header;
+  std::memcpy(&header, data.data(), sizeof(ChunkHeader));
+
+  if (header.type == "XXXX"_ts) {
+    constexpr std::uint32_t extendedSize =
+        2 * sizeof(ChunkHeader) + sizeof(std::uint32_t);
+    if (data.size() < extendedSize) {
+      return extendedSize;
     }
+
+    std::uint32_t dataSize;
+    std::memcpy(&dataSize, data.data() + sizeof(ChunkHeader), sizeof(dataSize));
+    return extendedSize + dataSize;
+  }
+
+  return sizeof(ChunkHeader) + header.dataSize;
+}
+
+template <ReaderHandler Handler>
+inline std::uint32_t Reader<Handler>::offsetOf(std::string_view data) const
+{
+  return static_cast<std::uint32_t>(data.data() - data_.data());
+}
+
+template <ReaderHandler Handler>
+inline void Reader<Handler>::countError()
+{
+  if (stats_) {
+    ++stats_->errors;
+  }
+}
+
+template <ReaderHandler Handler>
+inline Traversal Reader<Handler>::visit(TraversalResult auto result)
+{
+  if constexpr (std::same_as<decltype(result), Traversal>) {
+    stopped_ = stopped_ || result == Traversal::Stop;
+    return result;
+  } else {
+    return result ? Traversal::Descend : Traversal::Skip;
+  }
+}
+
+template <ReaderHandler Handler>
+constexpr bool Reader<Handler>::wantsForm(Type type)
+{
+  if constexpr (requires { Handler::WantedForms.contains(type); }) {
+    return Handler::WantedForms.contains(type);
+  } else {
+    return true;
+  }
+}
+
+template <ReaderHandler Handler>
+constexpr bool Reader<Handler>::wantsGroup(GroupType type)
+{
+  if constexpr (requires { Handler::WantedGroups.contains(type); }) {
+    return Handler::WantedGroups.contains(type);
+  } else {
+    return true;
+  }
+}
+
+template <ReaderHandler Handler>
+constexpr bool Reader<Handler>::wantsChunk(Type type)
+{
+  if constexpr (requires { Handler::WantedChunks.contains(type); }) {
+    return Handler::WantedChunks.contains(type);
+  } else {
+    return true;
   }
+}
 
-  return readSize;
+template <ReaderHandler Handler>
+inline bool Reader<Handler>::formComplete(Handler& handler)
+{
+  if constexpr (FormCompletionHandler<Handler>) {
+    return handler.FormComplete();
+  } else {
+    return false;
+  }
 }
 
 }  // namespace TESFile
@@ -0,0 +1,66 @@
+#include "ReaderStats.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <ranges>
+#include <vector>
+
+namespace TESFile
+{
+
+ReaderStats& ReaderStats::operator+=(const ReaderStats& other)
+{
+  bytesRead += other.bytesRead;
+  bytesSkipped += other.bytesSkipped;
+  compressedBytes += other.compressedBytes;
+  inflatedBytes += other.inflatedBytes;
+  inflateTime += other.inflateTime;
+  groupsVisited += other.groupsVisited;
+  groupsAccepted += other.groupsAccepted;
+  chunksDelivered += other.chunksDelivered;
+  errors += other.errors;
+
+  for (const auto& [type, counts] : other.forms) {
+    auto& total = forms[type];
+    total.visited += counts.visited;
+    total.accepted += counts.accepted;
+  }
+
+  return *this;
+}
+
+std::string ReaderStats::summary() const
+{
+  std::uint64_t formsVisited  = 0;
+  std::uint64_t formsAccepted = 0;
+  for (const auto& [type, counts] : forms) {
+    formsVisited += counts.visited;
+    formsAccepted += counts.accepted;
+  }
+
+  auto result = fmt::format(
+      "read {} bytes, skipped {} bytes, inflated {} -> {} bytes in {} ms, "
+      "groups {}/{}, records {}/{}, subrecords {}, errors {}",
+      bytesRead, bytesSkipped, compressedBytes, inflatedBytes,
+      std::chrono::duration_cast<std::chrono::milliseconds>(inflateTime).count(),
+      groupsAccepted, groupsVisited, formsAccepted, formsVisited, chunksDelivered,
+      errors);
+
+  // the record types that were read the most are the interesting ones
+  std::vector<std::pair<Type, FormCounts>> busiest{forms.begin(), forms.end()};
+  std::ranges::sort(busiest, std::ranges::greater{}, [](auto&& entry) {
+    return entry.second.accepted;
+  });
+
+  for (const auto& [type, counts] : busiest | std::views::take(8)) {
+    if (counts.accepted == 0) {
+      break;
+    }
+    result += fmt::format(", {} {}/{}", type.view(), counts.accepted, counts.visited);
+  }
+
+  return result;
+}
+
+}  // namespace TESFile
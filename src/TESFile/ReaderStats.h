@@ -0,0 +1,50 @@
+#ifndef TESFILE_READERSTATS_H
+#define TESFILE_READERSTATS_H
+
+#include "Type.h"
+
+#include <boost/container/flat_map.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace TESFile
+{
+
+// Counters collected by a Reader that has been given a stats sink. Each reader (and
+// each worker of a concurrent parse) fills its own instance, which can then be summed
+// per plugin or across plugins.
+struct ReaderStats
+{
+  struct FormCounts
+  {
+    std::uint64_t visited  = 0;
+    std::uint64_t accepted = 0;
+  };
+
+  // Bytes of records and group headers that were parsed
+  std::uint64_t bytesRead = 0;
+
+  // Bytes of groups and records stepped over without being parsed
+  std::uint64_t bytesSkipped = 0;
+
+  std::uint64_t compressedBytes = 0;
+  std::uint64_t inflatedBytes   = 0;
+  std::chrono::nanoseconds inflateTime{};
+
+  std::uint64_t groupsVisited   = 0;
+  std::uint64_t groupsAccepted  = 0;
+  std::uint64_t chunksDelivered = 0;
+  std::uint64_t errors          = 0;
+
+  boost::container::flat_map<Type, FormCounts> forms;
+
+  ReaderStats& operator+=(const ReaderStats& other);
+
+  [[nodiscard]] std::string summary() const;
+};
+
+}  // namespace TESFile
+
+#endif  // TESFILE_READERSTATS_H
@@ -8,11 +8,49 @@
 #include <cstring>
 #include <istream>
 #include <ranges>
+#include <streambuf>
+#include <string_view>
 #include <utility>
 
 namespace TESFile
 {
 
+// Stream buffer reading directly from memory owned by someone else
+class ViewStreamBuf final : public std::streambuf
+{
+public:
+  explicit ViewStreamBuf(std::string_view data)
+  {
+    const auto begin = const_cast<char*>(data.data());
+    setg(begin, begin, begin + data.size());
+  }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override
+  {
+    if (!(which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+    }
+
+    const off_type base = dir == std::ios_base::beg   ? 0
+                          : dir == std::ios_base::cur ? gptr() - eback()
+                                                      : egptr() - eback();
+    return seekpos(pos_type(base + off), which);
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+  {
+    const off_type off = pos;
+    if (!(which & std::ios_base::in) || off < 0 || off > egptr() - eback()) {
+      return pos_type(off_type(-1));
+    }
+
+    setg(eback(), eback() + off, egptr());
+    return pos;
+  }
+};
+
 template <typename T>
 inline T readType(std::istream& stream)
 {
@@ -57,6 +95,15 @@ struct less
   }
 };
 
+// Handlers decide from Group, Form and Chunk whether to descend into the element, skip
+// it, or stop reading altogether
+enum class Traversal
+{
+  Skip,
+  Descend,
+  Stop,
+};
+
 enum class TESFormat
 {
   Standard,
@@ -30,8 +30,8 @@ struct Type
 
   template <std::size_t N>
   constexpr Type(const char (&str)[N])
-      : value{[&]<std::size_t... N>(std::index_sequence<N...>) {
-          return ((static_cast<std::uint32_t>(str[N]) << N * 8U) | ...);
+      : value{[&]<std::size_t... I>(std::index_sequence<I...>) {
+          return ((static_cast<std::uint32_t>(str[I]) << I * 8U) | ...);
         }(std::make_index_sequence<N - 1>())}
   {}
 
@@ -0,0 +1,38 @@
+#ifndef TESFILE_TYPESET_H
+#define TESFILE_TYPESET_H
+
+#include "Type.h"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+
+namespace TESFile
+{
+
+// Set of record types, group types or subrecord types fixed at compile time, e.g.
+//   static constexpr TypeSet WantedChunks{"EDID"_ts, "FULL"_ts};
+template <typename T, std::size_t N>
+class TypeSet final
+{
+public:
+  template <std::same_as<T>... Ts>
+  constexpr TypeSet(Ts... values) : values_{values...}
+  {}
+
+  [[nodiscard]] constexpr bool contains(T value) const
+  {
+    return std::ranges::find(values_, value) != values_.end();
+  }
+
+private:
+  std::array<T, N> values_;
+};
+
+template <typename T, std::same_as<T>... Ts>
+TypeSet(T, Ts...) -> TypeSet<T, 1 + sizeof...(Ts)>;
+
+}  // namespace TESFile
+
+#endif  // TESFILE_TYPESET_H
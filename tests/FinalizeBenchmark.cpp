@@ -0,0 +1,95 @@
+// Times filling one top group of a file entry with records in random order, and
+// finalizing the entry, for groups of 10k, 100k and 1M records. Other record counts
+// can be given on the command line.
+
+#include "TESData/FileEntry.h"
+#include "TESData/RecordPath.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TESData;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+double millisecondsSince(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Timing
+{
+  double build;
+  double finalize;
+  bool sorted;
+};
+
+Timing run(std::uint32_t count)
+{
+  const FileId file = FileNames::intern("Benchmark.esm");
+  const std::vector<FileId> files{file};
+
+  std::vector<std::uint32_t> formIds(count);
+  std::iota(formIds.begin(), formIds.end(), 0x800U);
+  std::ranges::shuffle(formIds, std::mt19937(count));
+
+  RecordPath path;
+  path.push(TESFile::GroupData("NPC_"_ts.value, TESFile::GroupType::Top), files, file);
+
+  FileEntry entry{1, FileNames::name(file)};
+
+  const auto buildStart = Clock::now();
+  for (const std::uint32_t formId : formIds) {
+    path.setFormId(formId, files, file);
+    entry.createRecord(path, "Npc" + std::to_string(formId), "NPC_"_ts, true);
+  }
+  const double build = millisecondsSince(buildStart);
+
+  const auto finalizeStart = Clock::now();
+  entry.finalize();
+  const double finalize = millisecondsSince(finalizeStart);
+
+  // rows are looked up by index, and must come out in form ID order
+  const auto group    = entry.item(entry.children(*entry.dataRoot())[0]);
+  const auto children = entry.children(*group);
+  bool sorted         = children.size() == count;
+  for (std::uint32_t row = 0; sorted && row < children.size(); ++row) {
+    const auto child = entry.item(children[row]);
+    sorted = child->row == row && std::get<std::uint32_t>(child->key) == 0x800 + row;
+  }
+
+  return {build, finalize, sorted};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::vector<std::uint32_t> counts;
+  for (int i = 1; i < argc; ++i) {
+    counts.push_back(static_cast<std::uint32_t>(std::strtoul(argv[i], nullptr, 10)));
+  }
+  if (counts.empty()) {
+    counts = {10'000, 100'000, 1'000'000};
+  }
+
+  std::printf("%10s %12s %12s %12s\n", "records", "build ms", "finalize ms",
+              "total ms");
+  bool ok = true;
+  for (const std::uint32_t count : counts) {
+    const Timing timing = run(count);
+    std::printf("%10u %12.1f %12.1f %12.1f%s\n", count, timing.build, timing.finalize,
+                timing.build + timing.finalize, timing.sorted ? "" : "  (unsorted!)");
+    ok = ok && timing.sorted;
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
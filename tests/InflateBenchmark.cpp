@@ -0,0 +1,177 @@
+// Times the inflater on the compressed records of plugins, inflating each record in
+// full and also streaming only its first subrecord, as the reader does when it stops
+// after the editor ID. The plugins are given on the command line, in the record format
+// of Skyrim and later games. Without arguments, a synthetic mix of NPC_, LAND and
+// NAVM records is used instead.
+//
+// The benchmark is built once per inflate backend, see tests/CMakeLists.txt.
+
+#include "SyntheticPlugin.h"
+
+#include "TESFile/Inflater.h"
+#include "TESFile/Stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+constexpr int Rounds = 5;
+
+#ifdef TESFILE_INFLATE_LIBDEFLATE
+constexpr const char* Backend = "libdeflate";
+#else
+constexpr const char* Backend = "zlib";
+#endif
+
+struct CompressedRecord
+{
+  std::string_view data;
+  std::uint32_t size;
+};
+
+// Collects the compressed records of a plugin image. Groups are stepped into rather
+// than over, so that records in nested groups are found too.
+void collect(std::string_view plugin, std::vector<CompressedRecord>& records)
+{
+  std::size_t pos = 0;
+  while (pos + sizeof(TESFile::RecordHeader) <= plugin.size()) {
+    TESFile::RecordHeader header;
+    std::memcpy(&header, plugin.data() + pos, sizeof(header));
+    pos += sizeof(header);
+
+    if (header.type == "GRUP"_ts) {
+      continue;
+    }
+
+    const bool compressed = header.formData.flags & TESFile::RecordFlags::Compressed;
+    if (compressed && header.dataSize >= sizeof(std::uint32_t) &&
+        pos + header.dataSize <= plugin.size()) {
+      std::uint32_t size;
+      std::memcpy(&size, plugin.data() + pos, sizeof(size));
+      const auto data =
+          plugin.substr(pos + sizeof(size), header.dataSize - sizeof(size));
+      records.push_back({data, size});
+    }
+    pos += header.dataSize;
+  }
+}
+
+// Data shaped roughly like the records that masters compress: NPC_ records of mixed
+// fields, LAND height and normal maps that vary smoothly, and NAVM vertex and
+// triangle arrays
+std::string makeSyntheticPlugin()
+{
+  Tests::SyntheticPlugin plugin;
+  std::mt19937 rng(1);
+
+  for (std::uint32_t i = 0; i < 4000; ++i) {
+    std::string data(600 + rng() % 3000, '\0');
+    for (std::size_t j = 0; j < data.size(); ++j) {
+      data[j] = static_cast<char>(j % 16 < 8 ? rng() % 4 : rng() % 256);
+    }
+    plugin.addRecord("NPC_"_ts, 0x800 + i, "Npc" + std::to_string(i), data, true);
+  }
+
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    std::string data(33 * 33 * 4, '\0');
+    for (std::size_t j = 0; j < data.size(); ++j) {
+      const double wave = std::sin(static_cast<double>(j + i) / 40) * 20;
+      data[j]           = static_cast<char>(static_cast<int>(wave) + rng() % 3);
+    }
+    plugin.addRecord("LAND"_ts, 0x10000 + i, "", data, true);
+  }
+
+  for (std::uint32_t i = 0; i < 1000; ++i) {
+    std::vector<float> vertices(3 * (200 + rng() % 1500));
+    for (std::size_t j = 0; j < vertices.size(); ++j) {
+      vertices[j] = static_cast<float>(j / 3 * 64 + rng() % 64);
+    }
+    std::string data(reinterpret_cast<const char*>(vertices.data()),
+                     std::min<std::size_t>(vertices.size() * sizeof(float), 0xFFFF));
+    plugin.addRecord("NAVM"_ts, 0x20000 + i, "", data, true);
+  }
+
+  return plugin.build();
+}
+
+double millisecondsSince(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::vector<std::string> plugins;
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file{argv[i], std::ios::binary};
+    if (!file) {
+      std::fprintf(stderr, "cannot open %s\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+    plugins.emplace_back(std::istreambuf_iterator<char>(file),
+                         std::istreambuf_iterator<char>());
+  }
+  if (plugins.empty()) {
+    plugins.push_back(makeSyntheticPlugin());
+  }
+
+  std::vector<CompressedRecord> records;
+  for (const auto& plugin : plugins) {
+    collect(plugin, records);
+  }
+
+  std::size_t compressedSize = 0;
+  std::size_t inflatedSize   = 0;
+  for (const auto& record : records) {
+    compressedSize += record.data.size();
+    inflatedSize += record.size;
+  }
+
+  auto& inflater = TESFile::Inflater::local();
+
+  const auto fullStart = Clock::now();
+  for (int round = 0; round < Rounds; ++round) {
+    for (const auto& record : records) {
+      const auto buffer = inflater.inflate(record.data, record.size);
+      if (buffer.view().size() != record.size) {
+        std::fprintf(stderr, "record inflated to %zu bytes instead of %u\n",
+                     buffer.view().size(), record.size);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  const double full = millisecondsSince(fullStart) / Rounds;
+
+  const auto headStart = Clock::now();
+  for (int round = 0; round < Rounds; ++round) {
+    for (const auto& record : records) {
+      auto stream = inflater.stream(record.data, record.size);
+      stream.fill(sizeof(TESFile::ChunkHeader));
+    }
+  }
+  const double head = millisecondsSince(headStart) / Rounds;
+
+  std::printf("%s: %zu records, %.1f MiB compressed, %.1f MiB inflated\n", Backend,
+              records.size(), compressedSize / 1048576.0, inflatedSize / 1048576.0);
+  std::printf("  full records    %8.1f ms  %8.1f MiB/s\n", full,
+              inflatedSize / 1048576.0 / (full / 1000));
+  std::printf("  first subrecord %8.1f ms\n", head);
+
+  return EXIT_SUCCESS;
+}
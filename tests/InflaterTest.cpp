@@ -0,0 +1,90 @@
+// Checks that records inflate the same whether they are inflated in full or streamed,
+// including records much larger than the window the reader streams in. Built once per
+// inflate backend, see tests/CMakeLists.txt.
+
+#include "TESFile/Inflater.h"
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+#ifdef TESFILE_INFLATE_LIBDEFLATE
+constexpr const char* Backend = "libdeflate";
+#else
+constexpr const char* Backend = "zlib";
+#endif
+
+std::string compress(std::string_view data)
+{
+  uLongf size = compressBound(static_cast<uLong>(data.size()));
+  std::string out(size, '\0');
+  const int result = ::compress(reinterpret_cast<Bytef*>(out.data()), &size,
+                                reinterpret_cast<const Bytef*>(data.data()),
+                                static_cast<uLong>(data.size()));
+  if (result != Z_OK) {
+    throw std::runtime_error("failed to compress record");
+  }
+
+  out.resize(size);
+  return out;
+}
+
+std::string makeRecord(std::size_t size, std::mt19937& rng)
+{
+  std::string data(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<char>(i % 8 < 4 ? i / 64 : rng() % 256);
+  }
+  return data;
+}
+
+bool check(bool condition, const char* what, std::size_t size)
+{
+  if (!condition) {
+    std::fprintf(stderr, "%s: %s for a record of %zu bytes\n", Backend, what, size);
+  }
+  return condition;
+}
+
+}  // namespace
+
+int main()
+{
+  auto& inflater = TESFile::Inflater::local();
+  std::mt19937 rng(1);
+  bool ok = true;
+
+  for (const std::size_t size : {0, 6, 100, 0x200, 0x201, 5000, 70000, 1 << 20}) {
+    const std::string data       = makeRecord(size, rng);
+    const std::string compressed = compress(data);
+    const auto limit             = static_cast<std::uint32_t>(size);
+
+    try {
+      const auto buffer = inflater.inflate(compressed, limit);
+      ok &= check(buffer.view() == data, "inflate differs", size);
+
+      // the reader first asks for a subrecord header, then for its data
+      auto stream = inflater.stream(compressed, limit);
+      stream.fill(6);
+      ok &= check(stream.view().size() >= std::min<std::size_t>(6, size),
+                  "stream is short", size);
+      ok &= check(data.starts_with(stream.view()), "stream differs", size);
+
+      stream.fill(size);
+      ok &= check(stream.finished(), "stream did not finish", size);
+      ok &= check(stream.view() == data, "stream differs", size);
+    } catch (const std::exception& e) {
+      ok &= check(false, e.what(), size);
+    }
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
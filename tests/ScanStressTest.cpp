@@ -0,0 +1,506 @@
+// Scans synthetic plugins into a record index on several threads, in a different order
+// on every run, and checks that the index comes out the same each time and matches
+// what the plugins contain. Frozen entries are then read from other threads while
+// records are still added, and the conflict matrix is counted on several threads.
+// Meant to be run under ThreadSanitizer.
+
+#include "SyntheticPlugin.h"
+
+#include "TESData/AssociatedEntry.h"
+#include "TESData/ConflictMatrix.h"
+#include "TESData/FileEntry.h"
+#include "TESData/FormIdTable.h"
+#include "TESFile/Reader.h"
+#include "TESFile/TypeSet.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TESData;
+
+namespace
+{
+
+constexpr int MasterCount        = 2;
+constexpr int PluginCount        = 8;
+constexpr std::uint32_t Forms    = 1500;
+constexpr std::uint32_t Settings = 40;
+constexpr int Runs               = 6;
+
+// Record index of a load order, built the way the plugin list builds it
+class RecordIndex final
+{
+public:
+  // Entries are created up front in load order, so that handles do not depend on the
+  // order plugins are scanned in
+  explicit RecordIndex(const std::vector<std::string>& loadOrder)
+  {
+    createEntry(FileNames::None);
+    for (const auto& name : loadOrder) {
+      createEntry(FileNames::intern(name));
+    }
+  }
+
+  FileEntry* createEntry(FileId file)
+  {
+    {
+      std::shared_lock lk{m_Mutex};
+      if (file < m_EntriesByFile.size() && m_EntriesByFile[file]) {
+        return m_EntriesByFile[file].get();
+      }
+    }
+
+    std::unique_lock lk{m_Mutex};
+    if (file < m_EntriesByFile.size() && m_EntriesByFile[file]) {
+      return m_EntriesByFile[file].get();
+    }
+
+    const auto entry =
+        std::make_shared<FileEntry>(static_cast<TESFileHandle>(m_Entries.size()),
+                                    FileNames::name(file));
+    m_Entries.push_back(entry);
+    if (file >= m_EntriesByFile.size()) {
+      m_EntriesByFile.resize(file + 1);
+    }
+    m_EntriesByFile[file] = entry;
+    return entry.get();
+  }
+
+  void addRecordConflict(FileId plugin, const RecordPath& path, TESFile::Type type,
+                         const std::string& name)
+  {
+    const FileId master =
+        path.hasFormId() ? path.files()[path.formId() >> 24] : FileNames::None;
+    const auto owner  = createEntry(master);
+    const auto record = owner->createRecord(path, name, type, plugin == master);
+    if (path.hasFormId()) {
+      m_FormIds.insert(master, path.formId(), record);
+    }
+    if (plugin != master) {
+      createEntry(plugin)->addRecord(path, name, type, record);
+    }
+  }
+
+  [[nodiscard]] const std::vector<std::shared_ptr<FileEntry>>& entries() const
+  {
+    return m_Entries;
+  }
+
+  [[nodiscard]] FileEntry* entry(FileId file) const
+  {
+    return m_EntriesByFile[file].get();
+  }
+
+  [[nodiscard]] Record* findRecord(FileId file, std::uint32_t objectId) const
+  {
+    return m_FormIds.find(file, objectId);
+  }
+
+private:
+  mutable std::shared_mutex m_Mutex;
+  std::vector<std::shared_ptr<FileEntry>> m_Entries;
+  std::vector<std::shared_ptr<FileEntry>> m_EntriesByFile;
+  FormIdTable m_FormIds;
+};
+
+// Adds the overridden records of a plugin to the index, like the plugin list's
+// conflict parser
+class ConflictScanner final
+{
+public:
+  static constexpr TESFile::TypeSet WantedChunks{"MAST"_ts, "EDID"_ts};
+
+  ConflictScanner(RecordIndex* index, FileId plugin) : m_Index{index}, m_Plugin{plugin}
+  {}
+
+  bool Group(TESFile::GroupData group)
+  {
+    if (m_Masters.empty() && group.hasFormType() && group.formType() != "GMST"_ts) {
+      return false;
+    }
+
+    m_Path.push(group, m_Masters, m_Plugin);
+    return true;
+  }
+
+  void EndGroup() { m_Path.pop(); }
+
+  bool Form(TESFile::FormData form)
+  {
+    m_Type = form.type();
+    if (m_Path.groups().empty() || m_Type == "GMST"_ts) {
+      return true;
+    }
+
+    m_Path.setFormId(form.formId(), m_Masters, m_Plugin);
+    return form.localModIndex() < m_Masters.size();
+  }
+
+  void EndForm()
+  {
+    if (!m_Path.groups().empty() && m_Type != "GMST"_ts) {
+      m_Index->addRecordConflict(m_Plugin, m_Path, m_Type, m_Name);
+    }
+
+    m_Path.unsetFormId();
+    m_Name.clear();
+  }
+
+  bool Chunk(TESFile::Type type)
+  {
+    m_Chunk = type;
+    return m_Path.groups().empty() ? type == "MAST"_ts : type == "EDID"_ts;
+  }
+
+  void Data(TESFile::Cursor& data)
+  {
+    if (m_Chunk == "MAST"_ts) {
+      m_Masters.push_back(FileNames::intern(TESFile::readZstring(data)));
+    } else if (m_Type == "GMST"_ts) {
+      m_Path.setEditorId(std::string(TESFile::readZstring(data)));
+      m_Index->addRecordConflict(m_Plugin, m_Path, "GMST"_ts, "");
+    } else {
+      m_Name = TESFile::readZstring(data);
+    }
+  }
+
+private:
+  RecordIndex* m_Index;
+  FileId m_Plugin;
+  std::vector<FileId> m_Masters;
+  RecordPath m_Path;
+  TESFile::Type m_Type;
+  TESFile::Type m_Chunk;
+  std::string m_Name;
+};
+
+struct Plugin
+{
+  std::string name;
+  std::string data;
+};
+
+// Form records each plugin overrides, by master and object ID, and game settings by
+// editor ID
+struct Expected
+{
+  std::map<std::pair<int, std::uint32_t>, std::set<TESFileHandle>> forms;
+  std::map<std::string, std::set<TESFileHandle>> settings;
+};
+
+std::string masterName(int master)
+{
+  return "Master" + std::to_string(master) + ".esm";
+}
+
+std::string settingName(std::uint32_t setting)
+{
+  return "fSetting" + std::to_string(setting);
+}
+
+// Handle of the entry of a file, as created by RecordIndex: the entry without a
+// file first, then the load order
+TESFileHandle handleOf(int loadOrderIndex)
+{
+  return loadOrderIndex + 1;
+}
+
+std::vector<Plugin> makePlugins(Expected& expected)
+{
+  std::vector<Plugin> plugins;
+
+  for (int m = 0; m < MasterCount; ++m) {
+    Tests::SyntheticPlugin master;
+    for (std::uint32_t i = 0; i < Forms; ++i) {
+      master.addRecord(i % 4 ? "NPC_"_ts : "WEAP"_ts, 0x800 + i,
+                       "M" + std::to_string(m) + "Form" + std::to_string(i));
+    }
+    for (std::uint32_t i = 0; i < Settings; ++i) {
+      master.addRecord("GMST"_ts, 0x10000 + i, settingName(i + m * Settings / 2));
+      expected.settings[settingName(i + m * Settings / 2)].insert(handleOf(m));
+    }
+    plugins.push_back({masterName(m), master.build()});
+  }
+
+  for (int p = 0; p < PluginCount; ++p) {
+    const int handle = handleOf(MasterCount + p);
+
+    // odd plugins list their masters the other way around, so that local form IDs
+    // differ between plugins
+    std::vector<std::string> masters;
+    for (int m = 0; m < MasterCount; ++m) {
+      masters.push_back(masterName(p % 2 ? MasterCount - 1 - m : m));
+    }
+
+    Tests::SyntheticPlugin plugin{masters};
+    std::mt19937 rng(p);
+    for (std::uint32_t i = 0; i < Forms; ++i) {
+      for (std::uint32_t local = 0; local < MasterCount; ++local) {
+        if (rng() % 3 == 0) {
+          continue;
+        }
+
+        const int master = p % 2 ? MasterCount - 1 - local : local;
+        plugin.addRecord(i % 4 ? "NPC_"_ts : "WEAP"_ts, (local << 24U) | (0x800 + i),
+                         "P" + std::to_string(p) + "Name" + std::to_string(rng() % 5),
+                         std::string(rng() % 64, 'x'), i % 3 == 0);
+
+        auto& handles = expected.forms[{master, 0x800 + i}];
+        handles.insert(handleOf(master));
+        handles.insert(handle);
+      }
+    }
+
+    // records new to the plugin are not conflicts
+    for (std::uint32_t i = 0; i < 100; ++i) {
+      plugin.addRecord("NPC_"_ts, (MasterCount << 24U) | (0x800 + i), "New");
+    }
+
+    for (std::uint32_t i = 0; i < Settings * 2; ++i) {
+      if (rng() % 2) {
+        plugin.addRecord("GMST"_ts, (MasterCount << 24U) | (0x10000 + i),
+                         settingName(i), {}, i % 2 == 0);
+        expected.settings[settingName(i)].insert(handle);
+      }
+    }
+
+    plugins.push_back({"Plugin" + std::to_string(p) + ".esp", plugin.build()});
+  }
+
+  for (auto& handles : expected.settings | std::views::values) {
+    handles.insert(0);
+  }
+
+  return plugins;
+}
+
+void dump(const FileEntry& entry, FileEntry::ItemIndex index, std::ostringstream& os,
+          int depth)
+{
+  const auto item = entry.item(index);
+  os << std::string(depth, ' ') << item->key.index() << ' ' << item->name;
+  if (item->record) {
+    if (item->record->hasEditorId()) {
+      os << ' ' << item->record->editorId();
+    } else {
+      os << ' ' << item->record->file() << ':' << item->record->formId();
+    }
+    for (const auto handle : item->record->alternatives()) {
+      os << ' ' << handle;
+    }
+  }
+  os << '\n';
+
+  std::uint32_t row = 0;
+  for (const auto child : entry.children(*item)) {
+    if (entry.item(child)->row != row++) {
+      os << "bad row\n";
+    }
+    dump(entry, child, os, depth + 1);
+  }
+}
+
+bool check(bool condition, const char* what)
+{
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+  }
+  return condition;
+}
+
+// Scans the plugins on `threads` threads in the given order, and returns the index
+std::unique_ptr<RecordIndex> scan(const std::vector<Plugin>& plugins,
+                                  const std::vector<std::size_t>& order,
+                                  unsigned threads)
+{
+  std::vector<std::string> loadOrder;
+  for (const auto& plugin : plugins) {
+    loadOrder.push_back(plugin.name);
+  }
+  auto index = std::make_unique<RecordIndex>(loadOrder);
+
+  std::atomic<std::size_t> next = 0;
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&] {
+      for (std::size_t i = next++; i < order.size(); i = next++) {
+        const auto& plugin = plugins[order[i]];
+        ConflictScanner handler{index.get(), FileNames::intern(plugin.name)};
+        TESFile::Reader<ConflictScanner> reader;
+        reader.parse(std::string_view(plugin.data), handler);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (const auto& entry : index->entries()) {
+    entry->finalize();
+  }
+  return index;
+}
+
+bool checkIndex(const RecordIndex& index, const Expected& expected)
+{
+  bool ok = true;
+  for (const auto& [form, handles] : expected.forms) {
+    const auto record = index.findRecord(FileNames::intern(masterName(form.first)),
+                                         form.second);
+    ok &= check(record != nullptr, "form is indexed") &&
+          check(std::ranges::equal(record->alternatives(), handles),
+                "form alternatives");
+  }
+
+  const auto settings = index.entry(FileNames::None);
+  for (const auto& [editorId, handles] : expected.settings) {
+    RecordPath path;
+    path.push(TESFile::GroupData("GMST"_ts, TESFile::GroupType::Top), {},
+              FileNames::None);
+    path.setEditorId(editorId);
+    const auto record = settings->findRecord(path);
+    ok &= check(record != nullptr, "setting is indexed") &&
+          check(std::ranges::equal(record->alternatives(), handles),
+                "setting alternatives");
+  }
+  return ok;
+}
+
+// Reads frozen entries from other threads while the thread that froze them adds
+// records, as when a branch of the record tree is loaded lazily. Adding a record
+// also adds to the alternatives of records shared with other entries, so like the
+// plugin list, which stops counting conflicts first, the readers leave those alone.
+bool checkFrozenReads(RecordIndex& index, const Expected& expected)
+{
+  for (const auto& entry : index.entries()) {
+    entry->freeze();
+  }
+
+  std::atomic<bool> done = false;
+  std::atomic<std::size_t> reads = 0;
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; ++r) {
+    readers.emplace_back([&, r] {
+      while (!done) {
+        const auto& entry = *index.entries()[1 + r];
+        std::size_t count = 0;
+        entry.forEachRecord([&](const Record& record) {
+          count += record.hasFormId();
+        });
+        reads += count != 0;
+      }
+    });
+  }
+
+  const FileId plugin = FileNames::intern("Plugin0.esp");
+  const FileId master = FileNames::intern(masterName(0));
+  const std::vector<FileId> masters{master};
+  for (std::uint32_t i = 0; i < 2000; ++i) {
+    RecordPath path;
+    path.push(TESFile::GroupData("ARMO"_ts, TESFile::GroupType::Top), masters, plugin);
+    path.setFormId(0x100000 + i, masters, plugin);
+    index.addRecordConflict(plugin, path, "ARMO"_ts, "Lazy");
+  }
+  index.entry(master)->finalize();
+  index.entry(plugin)->finalize();
+
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  for (const auto& entry : index.entries()) {
+    entry->thaw();
+  }
+
+  bool ok = check(reads != 0, "frozen entries were read");
+  for (std::uint32_t i = 0; i < 2000; ++i) {
+    const auto record = index.findRecord(master, 0x100000 + i);
+    ok &= check(record && record->alternatives().size() == 2, "lazy record");
+  }
+  return ok && checkIndex(index, expected);
+}
+
+bool checkConflicts(const RecordIndex& index, const Expected& expected)
+{
+  std::map<std::pair<TESFileHandle, TESFileHandle>, std::uint32_t> counts;
+  const auto count = [&](const std::set<TESFileHandle>& handles) {
+    for (auto lhs = handles.begin(); lhs != handles.end(); ++lhs) {
+      for (auto rhs = std::next(lhs); rhs != handles.end(); ++rhs) {
+        ++counts[{*lhs, *rhs}];
+      }
+    }
+  };
+  for (const auto& handles : expected.forms | std::views::values) {
+    count(handles);
+  }
+  for (const auto& handles : expected.settings | std::views::values) {
+    count(handles);
+  }
+
+  const AssociatedEntry archives;
+  const std::atomic<bool> cancelled = false;
+  const auto matrix = ConflictMatrix::build(index.entries(), archives, 4, cancelled);
+
+  bool ok = check(matrix != nullptr, "conflicts counted");
+  const auto size = static_cast<TESFileHandle>(index.entries().size());
+  for (TESFileHandle lhs = 0; lhs < size; ++lhs) {
+    for (TESFileHandle rhs = lhs + 1; rhs < size; ++rhs) {
+      const auto it = counts.find({lhs, rhs});
+      ok &= check(matrix->overlap(lhs, rhs).records ==
+                      (it != counts.end() ? it->second : 0),
+                  "conflict count");
+    }
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main()
+{
+  Expected expected;
+  const auto plugins = makePlugins(expected);
+
+  std::vector<std::size_t> order(plugins.size());
+  std::iota(order.begin(), order.end(), 0);
+
+  std::string reference;
+  std::mt19937 rng(0);
+  for (int run = 0; run < Runs; ++run) {
+    std::ranges::shuffle(order, rng);
+    const auto index = scan(plugins, order, 2 + run % 3);
+
+    std::ostringstream os;
+    for (const auto& entry : index->entries()) {
+      dump(*entry, 0, os, 0);
+    }
+
+    if (run == 0) {
+      reference = os.str();
+      if (!checkIndex(*index, expected) || !checkConflicts(*index, expected) ||
+          !checkFrozenReads(*index, expected)) {
+        return 1;
+      }
+    } else if (!check(os.str() == reference, "index does not depend on scan order")) {
+      return 1;
+    }
+  }
+
+  std::printf("%d runs, %zu plugins, %zu bytes of index\n", Runs, plugins.size(),
+              reference.size());
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include "SyntheticPlugin.h"
+
+#include "TESFile/Stream.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Tests
+{
+
+template <typename T>
+static void append(std::string& out, const T& value)
+{
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void appendChunk(std::string& out, TESFile::Type type, std::string_view data)
+{
+  TESFile::ChunkHeader header;
+  header.type     = type;
+  header.dataSize = static_cast<std::uint16_t>(data.size());
+  append(out, header);
+  out.append(data);
+}
+
+static void appendZstringChunk(std::string& out, TESFile::Type type,
+                               std::string_view str)
+{
+  std::string data{str};
+  data.push_back('\0');
+  appendChunk(out, type, data);
+}
+
+static void appendRecord(std::string& out, TESFile::Type type, std::uint32_t flags,
+                         std::uint32_t formId, std::string_view data)
+{
+  TESFile::RecordHeader header{};
+  header.type            = type;
+  header.dataSize        = static_cast<std::uint32_t>(data.size());
+  header.formData.flags  = flags;
+  header.formData.formId = formId;
+  header.version         = 44;
+  append(out, header);
+  out.append(data);
+}
+
+static void appendGroup(std::string& out, std::uint32_t label, std::string_view data)
+{
+  TESFile::RecordHeader header{};
+  header.type                = "GRUP"_ts;
+  header.dataSize            = static_cast<std::uint32_t>(sizeof(header) + data.size());
+  header.groupData.label     = label;
+  header.groupData.groupType = TESFile::GroupType::Top;
+  append(out, header);
+  out.append(data);
+}
+
+static std::string compress(std::string_view data)
+{
+  uLongf size = compressBound(static_cast<uLong>(data.size()));
+  std::string out(sizeof(std::uint32_t) + size, '\0');
+
+  const auto inflatedSize = static_cast<std::uint32_t>(data.size());
+  std::memcpy(out.data(), &inflatedSize, sizeof(inflatedSize));
+
+  const int result =
+      ::compress(reinterpret_cast<Bytef*>(out.data() + sizeof(inflatedSize)), &size,
+                 reinterpret_cast<const Bytef*>(data.data()),
+                 static_cast<uLong>(data.size()));
+  if (result != Z_OK) {
+    throw std::runtime_error("failed to compress record");
+  }
+
+  out.resize(sizeof(inflatedSize) + size);
+  return out;
+}
+
+SyntheticPlugin::SyntheticPlugin(std::vector<std::string> masters)
+    : m_Masters{std::move(masters)}
+{}
+
+void SyntheticPlugin::addRecord(TESFile::Type type, std::uint32_t formId,
+                                std::string_view editorId, std::string_view data,
+                                bool compressed)
+{
+  std::string fields;
+  appendZstringChunk(fields, "EDID"_ts, editorId);
+  if (!data.empty()) {
+    appendChunk(fields, "DATA"_ts, data);
+  }
+
+  auto it = std::ranges::find(m_TopGroups, type, [](auto&& group) {
+    return group.first;
+  });
+  if (it == m_TopGroups.end()) {
+    it = m_TopGroups.emplace(m_TopGroups.end(), type, std::string());
+  }
+
+  if (compressed) {
+    appendRecord(it->second, type, TESFile::RecordFlags::Compressed, formId,
+                 compress(fields));
+  } else {
+    appendRecord(it->second, type, 0, formId, fields);
+  }
+
+  ++m_RecordCount;
+}
+
+std::string SyntheticPlugin::build() const
+{
+  struct Header
+  {
+    float version;
+    std::int32_t numRecords;
+    std::uint32_t nextObjectId;
+  };
+
+  std::string info;
+  std::string header(sizeof(Header), '\0');
+  const Header values{1.7F, static_cast<std::int32_t>(m_RecordCount), 0x800};
+  std::memcpy(header.data(), &values, sizeof(values));
+  appendChunk(info, "HEDR"_ts, header);
+  for (const auto& master : m_Masters) {
+    appendZstringChunk(info, "MAST"_ts, master);
+    appendChunk(info, "DATA"_ts, std::string(8, '\0'));
+  }
+
+  std::string out;
+  appendRecord(out, "TES4"_ts, 0, 0, info);
+  for (const auto& [type, records] : m_TopGroups) {
+    appendGroup(out, type.value, records);
+  }
+  return out;
+}
+
+}  // namespace Tests
@@ -0,0 +1,39 @@
+#ifndef TESTS_SYNTHETICPLUGIN_H
+#define TESTS_SYNTHETICPLUGIN_H
+
+#include "TESFile/Type.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Tests
+{
+
+// Builds plugin images in memory, so that tests and benchmarks do not depend on game
+// data. Records are written to the top group of their type in the order they are
+// added, and top groups in the order their types first appear.
+class SyntheticPlugin final
+{
+public:
+  explicit SyntheticPlugin(std::vector<std::string> masters = {});
+
+  // Adds a record with an editor ID and one more subrecord of arbitrary data. The
+  // top byte of `formId` indexes the masters, or is the master count for a record
+  // new to this plugin.
+  void addRecord(TESFile::Type type, std::uint32_t formId, std::string_view editorId,
+                 std::string_view data = {}, bool compressed = false);
+
+  [[nodiscard]] std::string build() const;
+
+private:
+  std::vector<std::string> m_Masters;
+  std::vector<std::pair<TESFile::Type, std::string>> m_TopGroups;
+  std::uint32_t m_RecordCount = 0;
+};
+
+}  // namespace Tests
+
+#endif  // TESTS_SYNTHETICPLUGIN_H